@@ -22,7 +22,6 @@ cmake \
     -D CMAKE_CXX_FLAGS="-march=native" \
     -D MPI_C_COMPILER=mpiicc \
     -D MPI_CXX_COMPILER=mpiicpc \
-    -D PC_BUILD_INTRINSICS=ON \
     -D PC_BUILD_BOOST_MPI_PI_CALCULATION=OFF
 cmake --build $self_dir/build-icpc --target all
 
@@ -1,47 +1,58 @@
 #!/bin/bash
 
 self_dir=`dirname "$0"`
+format_args=${PC_OUTPUT_FORMAT:+--format=$PC_OUTPUT_FORMAT}
+pin_args=${PC_PINNING:+--pin=$PC_PINNING}
 
 run_with_compiler()
 {
-    echo "$1 openmp"
+    echo "$1 openmp" >&2
     srun \
         --cpus-per-task=16 \
         --nodes=1 \
         --ntasks=1 \
-        $self_dir/build-$1/src/openmp/openmp
+        $self_dir/build-$1/src/openmp/openmp $format_args $pin_args
 
-    echo "$1 mpi-dot-product"
+    echo "$1 mpi-dot-product" >&2
     srun \
         --ntasks=16 \
         --nodes=4 \
         --tasks-per-node=4 \
         --cpus-per-task=1 \
-        $self_dir/build-$1/src/mpi-dot-product/mpi-dot-product
+        $self_dir/build-$1/src/mpi-dot-product/mpi-dot-product $format_args $pin_args
 
-    echo "$1 mpi-pi-calculation"
+    echo "$1 mpi-dot-product hybrid" >&2
+    srun \
+        --ntasks=4 \
+        --nodes=4 \
+        --tasks-per-node=1 \
+        --cpus-per-task=4 \
+        $self_dir/build-$1/src/mpi-dot-product/mpi-dot-product $format_args $pin_args --threads=4
+
+    echo "$1 mpi-pi-calculation" >&2
     srun \
         --ntasks=200 \
         --nodes=20 \
         --ntasks-per-node=10 \
         --cpus-per-task=1 \
-        $self_dir/build-$1/src/mpi-pi-calculation/mpi-pi-calculation
+        $self_dir/build-$1/src/mpi-pi-calculation/mpi-pi-calculation $format_args $pin_args
+
+    echo "$1 intrinsics" >&2
+    srun $self_dir/build-$1/src/intrinsics/intrinsics $format_args $pin_args 9876543210 123
 
-    echo "$1 cuda-dot-product"
+    echo "$1 cuda-dot-product" >&2
     srun \
         --gpus=1 \
-        $self_dir/build-$1/src/cuda-dot-product/cuda-dot-product
+        $self_dir/build-$1/src/cuda-dot-product/cuda-dot-product $format_args $pin_args
 }
 
 run_with_compiler g++
-echo "g++ boost-mpi-pi-calculation"
+echo "g++ boost-mpi-pi-calculation" >&2
 srun \
     --ntasks=200 \
     --nodes=20 \
     --ntasks-per-node=10 \
     --cpus-per-task=1 \
-    $self_dir/build-g++/src/boost-mpi-pi-calculation/boost-mpi-pi-calculation
+    $self_dir/build-g++/src/boost-mpi-pi-calculation/boost-mpi-pi-calculation $format_args $pin_args
 
 run_with_compiler icpc
-echo "icpc intrinsics"
-srun $self_dir/build-icpc/src/intrinsics/intrinsics 9876543210 123
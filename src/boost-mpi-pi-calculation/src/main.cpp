@@ -1,13 +1,18 @@
 #include <benchmark.hpp>
 #include <pi_helpers.hpp>
+#include <topology.hpp>
 
 #include <boost/mpi.hpp>
+#include <boost/serialization/string.hpp>
 #include <gmpxx.h>
 
 #include <cassert>
 #include <cmath>
 #include <iostream>
+#include <memory>
 #include <stdexcept>
+#include <string>
+#include <vector>
 
 namespace mpi = boost::mpi;
 
@@ -95,9 +100,10 @@ void benchmark(std::size_t summand_count,
                mp_bitcnt_t precision,
                const mpi::communicator& world,
                RegularPiCalculationFunction pi_regular,
-               MPIPiCalculationFunction pi_mpi)
+               MPIPiCalculationFunction pi_mpi,
+               my::ResultSink& sink)
 {
-    static constexpr std::size_t ITERATIONS_COUNT = 100;
+    static constexpr my::BenchmarkParams BENCHMARK_PARAMS = { .warmup_count = 2, .samples_count = 100 };
 
     if (summand_count < static_cast<std::size_t>(world.size()))
     {
@@ -110,21 +116,29 @@ void benchmark(std::size_t summand_count,
         {
             return pi_regular(summand_count, precision);
         };
-        double pi_regular_result = my::benchmark_function(pi_regular_wrapper, ITERATIONS_COUNT);
-        my::print_result("Regular time: ", pi_regular_result);
+        my::BenchmarkResult pi_regular_result = my::run_benchmark(pi_regular_wrapper, BENCHMARK_PARAMS);
+        sink.write({ .name = "Regular time",
+                     .params = { { "summands", static_cast<std::int64_t>(summand_count) },
+                                 { "precision", static_cast<std::int64_t>(precision) },
+                                 { "processes", std::int64_t{ 1 } } },
+                     .result = pi_regular_result });
     }
 
-    double pi_mpi_result;
+    my::BenchmarkResult pi_mpi_result;
     {
         auto pi_mpi_wrapper = [summand_count, precision, pi_mpi, world]()
         {
             return pi_mpi(summand_count, precision, world);
         };
-        pi_mpi_result = my::benchmark_function(pi_mpi_wrapper, ITERATIONS_COUNT);
+        pi_mpi_result = my::run_benchmark(pi_mpi_wrapper, BENCHMARK_PARAMS);
     }
     if (world.rank() == ROOT_ID)
     {
-        my::print_result("    MPI time: ", pi_mpi_result);
+        sink.write({ .name = "MPI time",
+                     .params = { { "summands", static_cast<std::int64_t>(summand_count) },
+                                 { "precision", static_cast<std::int64_t>(precision) },
+                                 { "processes", static_cast<std::int64_t>(world.size()) } },
+                     .result = pi_mpi_result });
     }
 }
 
@@ -152,6 +166,42 @@ void calculate(std::size_t summand_count,
     }
 }
 
+// Pins the process according to its rank on the node and prints placement of all processes
+void pin_process(my::OutputFormat format, const my::topology::Pinning& pinning, const mpi::communicator& world)
+{
+    // Boost.MPI has no wrapper for MPI_Comm_split_type
+    MPI_Comm node_comm_raw;
+    if (MPI_Comm_split_type(world, MPI_COMM_TYPE_SHARED, world.rank(), MPI_INFO_NULL, &node_comm_raw) != MPI_SUCCESS)
+    {
+        throw std::runtime_error("MPI_Comm_split_type failed");
+    }
+    mpi::communicator node_comm(node_comm_raw, mpi::comm_take_ownership);
+
+    my::topology::Topology topology = my::topology::Topology::detect();
+    std::vector<int> placement = my::topology::make_placement(topology, pinning, node_comm.size());
+    if (!placement.empty())
+    {
+        my::topology::pin_current_thread(placement[node_comm.rank()]);
+    }
+
+    std::string process_placement = mpi::environment::processor_name() + ":" + std::to_string(my::topology::current_cpu());
+    std::vector<std::string> placements;
+    mpi::gather(world, process_placement, placements, ROOT_ID);
+
+    if (world.rank() == ROOT_ID)
+    {
+        std::ostream& header = my::header_stream(format);
+        header << "Topology: " << topology.describe() << std::endl
+               << "Pinning: " << my::topology::to_string(pinning.policy) << std::endl
+               << "Placement:";
+        for (std::size_t process_id = 0; process_id < placements.size(); ++process_id)
+        {
+            header << (process_id % 4 == 0 ? "\n   " : "") << " process " << process_id << " -> " << placements[process_id] << ";";
+        }
+        header << std::endl;
+    }
+}
+
 }  // namespace
 
 int main(int argc, char* argv[]) try
@@ -159,6 +209,11 @@ int main(int argc, char* argv[]) try
     mpi::environment env(argc, argv);
     mpi::communicator world;
 
+    my::OutputFormat format = my::output_format_from_cmd_line(argc, argv);
+    pin_process(format, my::topology::pinning_from_string(my::find_cmd_line_option(argc, argv, "pin").value_or("none")), world);
+
+    std::unique_ptr<my::ResultSink> sink = my::make_result_sink(format, "boost-mpi-pi-calculation", 12);
+
     struct AlgorithmInfo
     {
         const std::function<mpf_class(std::size_t summand_count, mp_bitcnt_t precision)> pi_regular;
@@ -208,7 +263,8 @@ int main(int argc, char* argv[]) try
                   algorithm_info.params.precision,
                   world,
                   algorithm_info.pi_regular,
-                  algorithm_info.pi_mpi);
+                  algorithm_info.pi_mpi,
+                  *sink);
     }
     else
     {
@@ -1,5 +1,6 @@
 #include <benchmark.hpp>
 #include <interfaces.hpp>
+#include <topology.hpp>
 
 #include <cuda/runtime_api.hpp>
 
@@ -10,13 +11,14 @@
 #include <memory>
 #include <random>
 #include <string_view>
+#include <vector>
 
 namespace
 {
 
 static constexpr int MAX_BLOCK_DIM_SIZE = 65535;
 static constexpr int MAX_THREADS_COUNT = 256;
-static constexpr std::size_t ITERATIONS_COUNT = 10'000;
+static constexpr my::BenchmarkParams BENCHMARK_PARAMS = { .warmup_count = 100, .samples_count = 10'000 };
 
 template <typename T>
 T cpu_dot_product(const T* a, const T* b, int size) noexcept
@@ -238,8 +240,24 @@ T dot_product_gpu_host(const T* host_a, const T* host_b, int elements_count)
 
 }  // namespace
 
-int main() try
+int main(int argc, char* argv[]) try
 {
+    my::OutputFormat format = my::output_format_from_cmd_line(argc, argv);
+    my::topology::Pinning pinning = my::topology::pinning_from_string(my::find_cmd_line_option(argc, argv, "pin").value_or("none"));
+
+    // Only the host thread is pinned, it drives the GPU and runs the CPU version
+    my::topology::Topology topology = my::topology::Topology::detect();
+    std::vector<int> placement = my::topology::make_placement(topology, pinning, 1);
+    if (!placement.empty())
+    {
+        my::topology::pin_current_thread(placement.front());
+    }
+    my::header_stream(format) << "Topology: " << topology.describe() << std::endl
+                              << "Pinning: " << my::topology::to_string(pinning.policy)
+                              << ", running on cpu " << my::topology::current_cpu() << std::endl;
+
+    std::unique_ptr<my::ResultSink> sink = my::make_result_sink(format, "cuda-dot-product", 13);
+
     int elements_count = 1 << 23;
 
     auto host_a = cuda::memory::host::make_unique<double[]>(elements_count);
@@ -260,8 +278,10 @@ int main() try
         {
             return cpu_dot_product(host_a.get(), host_b.get(), elements_count);
         };
-        double dot_product_cpu_result = my::benchmark_function(dot_product_cpu_wrapper, ITERATIONS_COUNT);
-        my::print_result("     CPU time: ", dot_product_cpu_result);
+        my::BenchmarkResult dot_product_cpu_result = my::run_benchmark(dot_product_cpu_wrapper, BENCHMARK_PARAMS);
+        sink->write({ .name = "CPU time",
+                      .params = { { "size", std::int64_t{ elements_count } }, { "precision", "double" } },
+                      .result = dot_product_cpu_result });
     }
 
     {
@@ -269,8 +289,10 @@ int main() try
         {
             return dot_product_gpu_host(host_a.get(), host_b.get(), elements_count);
         };
-        double dot_product_gpu_host_result = my::benchmark_function(dot_product_gpu_host_wrapper, ITERATIONS_COUNT);
-        my::print_result("GPU time  (h): ", dot_product_gpu_host_result);
+        my::BenchmarkResult dot_product_gpu_host_result = my::run_benchmark(dot_product_gpu_host_wrapper, BENCHMARK_PARAMS);
+        sink->write({ .name = "GPU time (h)",
+                      .params = { { "size", std::int64_t{ elements_count } }, { "precision", "double" } },
+                      .result = dot_product_gpu_host_result });
     }
 
     {
@@ -286,8 +308,10 @@ int main() try
         {
             return dot_product_gpu_device(device_a.get(), device_b.get(), elements_count);
         };
-        double dot_product_gpu_device_result = my::benchmark_function(dot_product_gpu_device_wrapper, ITERATIONS_COUNT);
-        my::print_result("GPU time (d1): ", dot_product_gpu_device_result);
+        my::BenchmarkResult dot_product_gpu_device_result = my::run_benchmark(dot_product_gpu_device_wrapper, BENCHMARK_PARAMS);
+        sink->write({ .name = "GPU time (d1)",
+                      .params = { { "size", std::int64_t{ elements_count } }, { "precision", "double" } },
+                      .result = dot_product_gpu_device_result });
     }
 
     {
@@ -301,8 +325,10 @@ int main() try
         {
             return dot_product_gpu_device_prealloc(memory_resource, elements_count);
         };
-        double dot_product_gpu_device_prealloc_result = my::benchmark_function(dot_product_gpu_device_prealloc_wrapper, ITERATIONS_COUNT);
-        my::print_result("GPU time (d2): ", dot_product_gpu_device_prealloc_result);
+        my::BenchmarkResult dot_product_gpu_device_prealloc_result = my::run_benchmark(dot_product_gpu_device_prealloc_wrapper, BENCHMARK_PARAMS);
+        sink->write({ .name = "GPU time (d2)",
+                      .params = { { "size", std::int64_t{ elements_count } }, { "precision", "double" } },
+                      .result = dot_product_gpu_device_prealloc_result });
     }
 
     return EXIT_SUCCESS;
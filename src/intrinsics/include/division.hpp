@@ -0,0 +1,243 @@
+#ifndef PARALLEL_COMPUTING_INTRINSICS_DIVISION_HPP_
+#define PARALLEL_COMPUTING_INTRINSICS_DIVISION_HPP_
+
+#include <immintrin.h>
+
+#include <cstdint>
+#include <stdexcept>
+
+// Portable replacements of _mm256_div_epi64 from Intel SVML. Quotients are truncated
+// toward zero like scalar division; division by zero and INT64_MIN / -1 are undefined.
+// AVX-512DQ and AVX-512VL instructions are used when available, otherwise they are
+// emulated with AVX2. AVX2 must be enabled at compile time, the sample is not configured
+// otherwise (see src/intrinsics/CMakeLists.txt).
+
+namespace my::intrinsics
+{
+
+namespace detail
+{
+
+inline __m256i sign_mask_epi64(__m256i x)
+{
+    return _mm256_cmpgt_epi64(_mm256_setzero_si256(), x);
+}
+
+inline __m256i abs_epi64(__m256i x)
+{
+#if defined(__AVX512VL__)
+    return _mm256_abs_epi64(x);
+#else
+    __m256i sign = sign_mask_epi64(x);
+    return _mm256_sub_epi64(_mm256_xor_si256(x, sign), sign);
+#endif
+}
+
+inline __m256i srai_epi64(__m256i x, __m128i count)
+{
+#if defined(__AVX512VL__)
+    return _mm256_sra_epi64(x, count);
+#else
+    // Shift by 64 - count yields zero for count == 0
+    __m128i complement = _mm_sub_epi64(_mm_set_epi64x(0, 64), count);
+    return _mm256_or_si256(_mm256_srl_epi64(x, count), _mm256_sll_epi64(sign_mask_epi64(x), complement));
+#endif
+}
+
+// Low 64 bits of the product
+inline __m256i mullo_epi64(__m256i a, __m256i b)
+{
+#if defined(__AVX512DQ__) && defined(__AVX512VL__)
+    return _mm256_mullo_epi64(a, b);
+#else
+    __m256i lo_lo = _mm256_mul_epu32(a, b);
+    __m256i hi_lo = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), b);
+    __m256i lo_hi = _mm256_mul_epu32(a, _mm256_srli_epi64(b, 32));
+    return _mm256_add_epi64(lo_lo, _mm256_slli_epi64(_mm256_add_epi64(hi_lo, lo_hi), 32));
+#endif
+}
+
+// High 64 bits of the unsigned 128-bit product, there is no such instruction even in AVX-512
+inline __m256i mulhi_epu64(__m256i a, __m256i b)
+{
+    const __m256i low_mask = _mm256_set1_epi64x(0xFFFFFFFF);
+    __m256i a_hi = _mm256_srli_epi64(a, 32);
+    __m256i b_hi = _mm256_srli_epi64(b, 32);
+    __m256i lo_lo = _mm256_mul_epu32(a, b);
+    __m256i hi_lo = _mm256_mul_epu32(a_hi, b);
+    __m256i lo_hi = _mm256_mul_epu32(a, b_hi);
+    __m256i hi_hi = _mm256_mul_epu32(a_hi, b_hi);
+    // Neither of the sums below can overflow: (2^32 - 1)^2 + 2 * (2^32 - 1) < 2^64
+    __m256i middle = _mm256_add_epi64(hi_lo, _mm256_srli_epi64(lo_lo, 32));
+    __m256i middle_lo = _mm256_add_epi64(_mm256_and_si256(middle, low_mask), lo_hi);
+    return _mm256_add_epi64(_mm256_add_epi64(hi_hi, _mm256_srli_epi64(middle, 32)), _mm256_srli_epi64(middle_lo, 32));
+}
+
+// Full int64 range, rounded to nearest
+inline __m256d cvtepi64_pd(__m256i x)
+{
+#if defined(__AVX512DQ__) && defined(__AVX512VL__)
+    return _mm256_cvtepi64_pd(x);
+#else
+    // High 48 and low 16 bits are put into mantissas of 3 * 2^67 and 2^52 respectively
+    __m256i high = _mm256_srai_epi32(x, 16);
+    high = _mm256_blend_epi16(high, _mm256_setzero_si256(), 0x33);
+    high = _mm256_add_epi64(high, _mm256_castpd_si256(_mm256_set1_pd(442721857769029238784.0)));
+    __m256i low = _mm256_blend_epi16(x, _mm256_castpd_si256(_mm256_set1_pd(0x0010000000000000)), 0x88);
+    __m256d high_value = _mm256_sub_pd(_mm256_castsi256_pd(high), _mm256_set1_pd(442726361368656609280.0));
+    return _mm256_add_pd(high_value, _mm256_castsi256_pd(low));
+#endif
+}
+
+// Full int64 range, truncated toward zero
+inline __m256i cvttpd_epi64(__m256d x)
+{
+#if defined(__AVX512DQ__) && defined(__AVX512VL__)
+    return _mm256_cvttpd_epi64(x);
+#else
+    // x = high * 2^32 + low, where |high| < 2^31 and 0 <= low < 2^32 are exact
+    // integers. Both are converted by adding 1.5 * 2^52 which is exact for |v| < 2^51.
+    const __m256d magic = _mm256_set1_pd(6755399441055744.0);
+    x = _mm256_round_pd(x, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+    __m256d high = _mm256_floor_pd(_mm256_mul_pd(x, _mm256_set1_pd(1.0 / 4294967296.0)));
+    __m256d low = _mm256_sub_pd(x, _mm256_mul_pd(high, _mm256_set1_pd(4294967296.0)));
+    __m256i high_int = _mm256_sub_epi64(_mm256_castpd_si256(_mm256_add_pd(high, magic)), _mm256_castpd_si256(magic));
+    __m256i low_int = _mm256_sub_epi64(_mm256_castpd_si256(_mm256_add_pd(low, magic)), _mm256_castpd_si256(magic));
+    return _mm256_add_epi64(_mm256_slli_epi64(high_int, 32), low_int);
+#endif
+}
+
+}  // namespace detail
+
+// General path for arbitrary divisors. The quotient is estimated in double precision,
+// refined once with the remainder (the estimate may be off by up to 2^11 for dividends
+// exceeding 2^53) and finally corrected by one.
+inline __m256i div_epi64(__m256i a, __m256i b)
+{
+    __m256d b_double = detail::cvtepi64_pd(b);
+
+    __m256i q = detail::cvttpd_epi64(_mm256_div_pd(detail::cvtepi64_pd(a), b_double));
+    __m256i r = _mm256_sub_epi64(a, detail::mullo_epi64(q, b));
+    q = _mm256_add_epi64(q, detail::cvttpd_epi64(_mm256_div_pd(detail::cvtepi64_pd(r), b_double)));
+    r = _mm256_sub_epi64(a, detail::mullo_epi64(q, b));
+
+    // Truncated division requires sign(r) == sign(a) (or r == 0) and |r| < |b|
+    const __m256i sign_bit = _mm256_set1_epi64x(INT64_MIN);
+    __m256i a_sign = detail::sign_mask_epi64(a);
+    __m256i r_sign = detail::sign_mask_epi64(r);
+    // +1 if the exact quotient is positive, -1 otherwise
+    __m256i step = _mm256_or_si256(_mm256_xor_si256(a_sign, detail::sign_mask_epi64(b)), _mm256_set1_epi64x(1));
+    __m256i r_is_zero = _mm256_cmpeq_epi64(r, _mm256_setzero_si256());
+    __m256i too_far = _mm256_andnot_si256(r_is_zero, _mm256_xor_si256(r_sign, a_sign));
+    // Unsigned |r| >= |b|, which also works for |INT64_MIN|
+    __m256i not_far_enough = _mm256_andnot_si256(_mm256_cmpgt_epi64(_mm256_xor_si256(detail::abs_epi64(b), sign_bit),
+                                                                    _mm256_xor_si256(detail::abs_epi64(r), sign_bit)),
+                                                 _mm256_set1_epi64x(-1));
+    q = _mm256_sub_epi64(q, _mm256_and_si256(too_far, step));
+    return _mm256_add_epi64(q, _mm256_and_si256(not_far_enough, step));
+}
+
+// Division by a divisor known in advance, replaced with multiplication by a precomputed
+// magic number and shifts (H. S. Warren, Hacker's Delight, chapter 10)
+class InvariantDivisor
+{
+public:
+    explicit InvariantDivisor(std::int64_t divisor)
+        : m_divisor(divisor)
+    {
+        if (divisor == 0)
+        {
+            throw std::invalid_argument("Division by zero");
+        }
+        if (divisor == 1 || divisor == -1)
+        {
+            return;
+        }
+
+        static constexpr std::uint64_t TWO_63 = std::uint64_t{ 1 } << 63;
+        std::uint64_t abs_divisor = (divisor < 0 ? std::uint64_t{ 0 } - static_cast<std::uint64_t>(divisor)
+                                                 : static_cast<std::uint64_t>(divisor));
+        std::uint64_t t = TWO_63 + (static_cast<std::uint64_t>(divisor) >> 63);
+        // Absolute value of the numerator limit
+        std::uint64_t anc = t - 1 - t % abs_divisor;
+        int p = 63;
+        std::uint64_t q1 = TWO_63 / anc;
+        std::uint64_t r1 = TWO_63 - q1 * anc;
+        std::uint64_t q2 = TWO_63 / abs_divisor;
+        std::uint64_t r2 = TWO_63 - q2 * abs_divisor;
+        std::uint64_t delta;
+        do
+        {
+            ++p;
+            q1 *= 2;
+            r1 *= 2;
+            if (r1 >= anc)
+            {
+                ++q1;
+                r1 -= anc;
+            }
+            q2 *= 2;
+            r2 *= 2;
+            if (r2 >= abs_divisor)
+            {
+                ++q2;
+                r2 -= abs_divisor;
+            }
+            delta = abs_divisor - r2;
+        } while (q1 < delta || (q1 == delta && r1 == 0));
+
+        std::int64_t magic = static_cast<std::int64_t>(q2 + 1);
+        if (divisor < 0)
+        {
+            magic = -magic;
+        }
+
+        m_magic = _mm256_set1_epi64x(magic);
+        m_magic_sign = _mm256_set1_epi64x(magic < 0 ? -1 : 0);
+        m_shift = _mm_set_epi64x(0, p - 64);
+        m_add_dividend = _mm256_set1_epi64x(divisor > 0 && magic < 0 ? -1 : 0);
+        m_subtract_dividend = _mm256_set1_epi64x(divisor < 0 && magic > 0 ? -1 : 0);
+    }
+
+    std::int64_t divisor() const
+    {
+        return m_divisor;
+    }
+
+    __m256i divide(__m256i a) const
+    {
+        if (m_divisor == 1)
+        {
+            return a;
+        }
+        if (m_divisor == -1)
+        {
+            return _mm256_sub_epi64(_mm256_setzero_si256(), a);
+        }
+
+        // Signed high half of the product from the unsigned one
+        __m256i q = detail::mulhi_epu64(a, m_magic);
+        q = _mm256_sub_epi64(q, _mm256_and_si256(detail::sign_mask_epi64(a), m_magic));
+        q = _mm256_sub_epi64(q, _mm256_and_si256(m_magic_sign, a));
+
+        q = _mm256_add_epi64(q, _mm256_and_si256(m_add_dividend, a));
+        q = _mm256_sub_epi64(q, _mm256_and_si256(m_subtract_dividend, a));
+        q = detail::srai_epi64(q, m_shift);
+        // Round toward zero: add 1 to negative quotients
+        return _mm256_add_epi64(q, _mm256_srli_epi64(q, 63));
+    }
+
+private:
+    std::int64_t m_divisor;
+    __m256i m_magic = _mm256_setzero_si256();
+    // All ones if the magic number is negative
+    __m256i m_magic_sign = _mm256_setzero_si256();
+    __m128i m_shift = _mm_setzero_si128();
+    // All ones if the dividend should be added to (subtracted from) the product
+    __m256i m_add_dividend = _mm256_setzero_si256();
+    __m256i m_subtract_dividend = _mm256_setzero_si256();
+};
+
+}  // namespace my::intrinsics
+
+#endif  // PARALLEL_COMPUTING_INTRINSICS_DIVISION_HPP_
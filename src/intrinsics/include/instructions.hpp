@@ -0,0 +1,48 @@
+#ifndef PARALLEL_COMPUTING_INTRINSICS_INSTRUCTIONS_HPP_
+#define PARALLEL_COMPUTING_INTRINSICS_INSTRUCTIONS_HPP_
+
+#include <benchmark.hpp>
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace my::intrinsics
+{
+
+enum class Mode
+{
+    // One dependency chain: every instruction waits for the result of the previous one
+    LATENCY,
+    // THROUGHPUT_CHAINS_COUNT independent chains, enough to saturate all execution ports
+    THROUGHPUT,
+};
+
+std::string_view to_string(Mode mode);
+
+inline constexpr std::size_t THROUGHPUT_CHAINS_COUNT = 10;
+
+struct InstructionKernel
+{
+    // add, mul, fma, div, sqrt, shuffle or gather
+    std::string_view operation;
+    // int32, int64, float or double
+    std::string_view type;
+    // scalar, SSE (128 bits), AVX2 (256 bits) or AVX-512 (512 bits)
+    std::string_view width;
+    // Runs steps_count steps of every chain, result is normalized to one instruction
+    std::function<TicksAndNanoseconds(Mode mode, std::size_t steps_count)> measure;
+};
+
+// Operation, type and width combinations supported by the instruction set the sample
+// is compiled for (e.g. with -march=native), in the order they should be reported
+const std::vector<InstructionKernel>& instruction_kernels();
+
+// E.g. "SSE4.1 AVX AVX2 FMA AVX-512F AVX-512DQ AVX-512VL"
+std::string enabled_extensions();
+
+}  // namespace my::intrinsics
+
+#endif  // PARALLEL_COMPUTING_INTRINSICS_INSTRUCTIONS_HPP_
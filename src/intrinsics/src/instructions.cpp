@@ -0,0 +1,406 @@
+#include <instructions.hpp>
+
+#include <immintrin.h>
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+namespace my::intrinsics
+{
+
+namespace
+{
+
+template <typename Scalar>
+constexpr std::string_view type_name()
+{
+    if constexpr (std::is_same_v<Scalar, std::int32_t>)
+        return "int32";
+    else if constexpr (std::is_same_v<Scalar, std::int64_t>)
+        return "int64";
+    else if constexpr (std::is_same_v<Scalar, float>)
+        return "float";
+    else
+        return "double";
+}
+
+// Signed integer of the same size as Scalar, used as gather indices
+template <typename Scalar>
+using index_t = std::conditional_t<sizeof(Scalar) == sizeof(std::int32_t), std::int32_t, std::int64_t>;
+
+// Chains start from a value which survives any number of steps,
+// see identity operands in instruction_kernels()
+template <typename Scalar>
+constexpr Scalar initial_value()
+{
+    if constexpr (std::is_integral_v<Scalar>)
+        return std::numeric_limits<Scalar>::max() / 3;
+    else
+        return Scalar(1.5);
+}
+
+template <typename Vector, typename Scalar>
+Vector broadcast(Scalar scalar)
+{
+    static_assert(sizeof(Vector) % sizeof(Scalar) == 0, "Size of vector is not multiple of size of scalar");
+    std::array<Scalar, sizeof(Vector) / sizeof(Scalar)> array;
+    array.fill(scalar);
+    Vector vector;
+    std::memcpy(&vector, array.data(), sizeof(vector));
+    return vector;
+}
+
+// Lanes of the result are {0, 1, 2, ...} reinterpreted as Scalar
+template <typename Vector, typename Scalar>
+Vector lane_indices()
+{
+    std::array<index_t<Scalar>, sizeof(Vector) / sizeof(Scalar)> array;
+    for (std::size_t i = 0; i < array.size(); ++i)
+        array[i] = static_cast<index_t<Scalar>>(i);
+    Vector vector;
+    std::memcpy(&vector, array.data(), sizeof(vector));
+    return vector;
+}
+
+static constexpr std::size_t GATHER_TABLE_SIZE = 64;
+
+template <typename Index>
+constexpr std::array<Index, GATHER_TABLE_SIZE> make_gather_table()
+{
+    std::array<Index, GATHER_TABLE_SIZE> table{};
+    for (std::size_t i = 0; i < table.size(); ++i)
+        table[i] = static_cast<Index>(i);
+    return table;
+}
+
+// Every element holds its own index, so gathering with indices taken from
+// the previous gather result forms a dependency chain of gathers
+template <typename Scalar>
+alignas(64) constexpr std::array<index_t<Scalar>, GATHER_TABLE_SIZE> GATHER_TABLE = make_gather_table<index_t<Scalar>>();
+
+template <typename Scalar>
+const Scalar* gather_table()
+{
+    return reinterpret_cast<const Scalar*>(GATHER_TABLE<Scalar>.data());
+}
+
+template <typename Vector, typename Operation, std::size_t... Indices>
+inline __attribute__((always_inline)) void step_chains(std::array<Vector, sizeof...(Indices)>& chains, Vector operand,
+                                                       Operation operation, std::index_sequence<Indices...>)
+{
+    ((chains[Indices] = operation(chains[Indices], operand), keep_in_register(chains[Indices])), ...);
+}
+
+template <typename Vector, typename Operation>
+TicksAndNanoseconds measure(Mode mode, Vector initial, Vector operand, Operation operation, std::size_t steps_count)
+{
+    asm volatile("# instruction kernel enter");
+    keep_in_register(operand);
+    TicksAndNanoseconds result;
+    if (mode == Mode::LATENCY)
+    {
+        Vector chain = initial;
+        {
+            Timer timer(result, steps_count);
+            for (std::size_t i = 0; i < steps_count; ++i)
+            {
+                chain = operation(chain, operand);
+                keep_in_register(chain);
+            }
+        }
+        do_not_optimize(chain);
+    }
+    else
+    {
+        std::array<Vector, THROUGHPUT_CHAINS_COUNT> chains;
+        chains.fill(initial);
+        {
+            Timer timer(result, steps_count * THROUGHPUT_CHAINS_COUNT);
+            for (std::size_t i = 0; i < steps_count; ++i)
+            {
+                step_chains(chains, operand, operation, std::make_index_sequence<THROUGHPUT_CHAINS_COUNT>{});
+            }
+        }
+        do_not_optimize(chains);
+    }
+    asm volatile("# instruction kernel exit");
+    return result;
+}
+
+// Operation takes (chain, operand) and returns new chain value. The operand is the
+// identity element of the operation, so chain values do not change and do not hit
+// slow paths like denormals or overflow.
+template <typename Scalar, typename Vector, typename Operation>
+InstructionKernel make_kernel(std::string_view operation_name, std::string_view width,
+                              Scalar operand, Operation operation)
+{
+    return { .operation = operation_name,
+             .type = type_name<Scalar>(),
+             .width = width,
+             .measure = [operand, operation](Mode mode, std::size_t steps_count)
+                        {
+                            return measure(mode, broadcast<Vector>(initial_value<Scalar>()), broadcast<Vector>(operand),
+                                           operation, steps_count);
+                        } };
+}
+
+// Operation takes (indices, unused) and returns values gathered from gather_table<Scalar>()
+template <typename Scalar, typename Vector, typename Operation>
+InstructionKernel make_gather_kernel(std::string_view width, Operation operation)
+{
+    return { .operation = "gather",
+             .type = type_name<Scalar>(),
+             .width = width,
+             .measure = [operation](Mode mode, std::size_t steps_count)
+                        {
+                            return measure(mode, lane_indices<Vector, Scalar>(), lane_indices<Vector, Scalar>(),
+                                           operation, steps_count);
+                        } };
+}
+
+#if defined(__AVX512F__)
+// Masked forms of some AVX-512 intrinsics are used with all lanes enabled: unmasked ones
+// leave the source undefined, which makes GCC emit false -Wmaybe-uninitialized warnings
+static constexpr __mmask16 ALL_LANES_16 = 0xFFFF;
+static constexpr __mmask8 ALL_LANES_8 = 0xFF;
+#endif
+
+std::vector<InstructionKernel> make_instruction_kernels()
+{
+    using i32 = std::int32_t;
+    using i64 = std::int64_t;
+
+    std::vector<InstructionKernel> kernels;
+
+    // add
+    kernels.emplace_back(make_kernel<i32, i32>("add", "scalar", 0, [](i32 x, i32 y) { return x + y; }));
+    kernels.emplace_back(make_kernel<i64, i64>("add", "scalar", 0, [](i64 x, i64 y) { return x + y; }));
+    kernels.emplace_back(make_kernel<float, float>("add", "scalar", 0, [](float x, float y) { return x + y; }));
+    kernels.emplace_back(make_kernel<double, double>("add", "scalar", 0, [](double x, double y) { return x + y; }));
+    kernels.emplace_back(make_kernel<i32, __m128i>("add", "SSE", 0, [](__m128i x, __m128i y) { return _mm_add_epi32(x, y); }));
+    kernels.emplace_back(make_kernel<i64, __m128i>("add", "SSE", 0, [](__m128i x, __m128i y) { return _mm_add_epi64(x, y); }));
+    kernels.emplace_back(make_kernel<float, __m128>("add", "SSE", 0, [](__m128 x, __m128 y) { return _mm_add_ps(x, y); }));
+    kernels.emplace_back(make_kernel<double, __m128d>("add", "SSE", 0, [](__m128d x, __m128d y) { return _mm_add_pd(x, y); }));
+#if defined(__AVX2__)
+    kernels.emplace_back(make_kernel<i32, __m256i>("add", "AVX2", 0, [](__m256i x, __m256i y) { return _mm256_add_epi32(x, y); }));
+    kernels.emplace_back(make_kernel<i64, __m256i>("add", "AVX2", 0, [](__m256i x, __m256i y) { return _mm256_add_epi64(x, y); }));
+    kernels.emplace_back(make_kernel<float, __m256>("add", "AVX2", 0, [](__m256 x, __m256 y) { return _mm256_add_ps(x, y); }));
+    kernels.emplace_back(make_kernel<double, __m256d>("add", "AVX2", 0, [](__m256d x, __m256d y) { return _mm256_add_pd(x, y); }));
+#endif
+#if defined(__AVX512F__)
+    kernels.emplace_back(make_kernel<i32, __m512i>("add", "AVX-512", 0, [](__m512i x, __m512i y) { return _mm512_add_epi32(x, y); }));
+    kernels.emplace_back(make_kernel<i64, __m512i>("add", "AVX-512", 0, [](__m512i x, __m512i y) { return _mm512_add_epi64(x, y); }));
+    kernels.emplace_back(make_kernel<float, __m512>("add", "AVX-512", 0, [](__m512 x, __m512 y) { return _mm512_add_ps(x, y); }));
+    kernels.emplace_back(make_kernel<double, __m512d>("add", "AVX-512", 0, [](__m512d x, __m512d y) { return _mm512_add_pd(x, y); }));
+#endif
+
+    // mul, 64-bit vector multiplication (low half) appeared in AVX-512DQ only
+    kernels.emplace_back(make_kernel<i32, i32>("mul", "scalar", 1, [](i32 x, i32 y) { return x * y; }));
+    kernels.emplace_back(make_kernel<i64, i64>("mul", "scalar", 1, [](i64 x, i64 y) { return x * y; }));
+    kernels.emplace_back(make_kernel<float, float>("mul", "scalar", 1, [](float x, float y) { return x * y; }));
+    kernels.emplace_back(make_kernel<double, double>("mul", "scalar", 1, [](double x, double y) { return x * y; }));
+#if defined(__SSE4_1__)
+    kernels.emplace_back(make_kernel<i32, __m128i>("mul", "SSE", 1, [](__m128i x, __m128i y) { return _mm_mullo_epi32(x, y); }));
+#endif
+#if defined(__AVX512DQ__) && defined(__AVX512VL__)
+    kernels.emplace_back(make_kernel<i64, __m128i>("mul", "SSE", 1, [](__m128i x, __m128i y) { return _mm_mullo_epi64(x, y); }));
+#endif
+    kernels.emplace_back(make_kernel<float, __m128>("mul", "SSE", 1, [](__m128 x, __m128 y) { return _mm_mul_ps(x, y); }));
+    kernels.emplace_back(make_kernel<double, __m128d>("mul", "SSE", 1, [](__m128d x, __m128d y) { return _mm_mul_pd(x, y); }));
+#if defined(__AVX2__)
+    kernels.emplace_back(make_kernel<i32, __m256i>("mul", "AVX2", 1, [](__m256i x, __m256i y) { return _mm256_mullo_epi32(x, y); }));
+#endif
+#if defined(__AVX512DQ__) && defined(__AVX512VL__)
+    kernels.emplace_back(make_kernel<i64, __m256i>("mul", "AVX2", 1, [](__m256i x, __m256i y) { return _mm256_mullo_epi64(x, y); }));
+#endif
+#if defined(__AVX2__)
+    kernels.emplace_back(make_kernel<float, __m256>("mul", "AVX2", 1, [](__m256 x, __m256 y) { return _mm256_mul_ps(x, y); }));
+    kernels.emplace_back(make_kernel<double, __m256d>("mul", "AVX2", 1, [](__m256d x, __m256d y) { return _mm256_mul_pd(x, y); }));
+#endif
+#if defined(__AVX512F__)
+    kernels.emplace_back(make_kernel<i32, __m512i>("mul", "AVX-512", 1, [](__m512i x, __m512i y) { return _mm512_mullo_epi32(x, y); }));
+#endif
+#if defined(__AVX512DQ__)
+    kernels.emplace_back(make_kernel<i64, __m512i>("mul", "AVX-512", 1, [](__m512i x, __m512i y) { return _mm512_mullo_epi64(x, y); }));
+#endif
+#if defined(__AVX512F__)
+    kernels.emplace_back(make_kernel<float, __m512>("mul", "AVX-512", 1, [](__m512 x, __m512 y) { return _mm512_mul_ps(x, y); }));
+    kernels.emplace_back(make_kernel<double, __m512d>("mul", "AVX-512", 1, [](__m512d x, __m512d y) { return _mm512_mul_pd(x, y); }));
+#endif
+
+    // fma, x * 1 + 0; there is no integer FMA on x86 (except 52-bit AVX-512IFMA)
+#if defined(__FMA__)
+    kernels.emplace_back(make_kernel<float, float>("fma", "scalar", 1, [](float x, float y) { return std::fma(x, y, 0.0f); }));
+    kernels.emplace_back(make_kernel<double, double>("fma", "scalar", 1, [](double x, double y) { return std::fma(x, y, 0.0); }));
+    kernels.emplace_back(make_kernel<float, __m128>("fma", "SSE", 1, [](__m128 x, __m128 y) { return _mm_fmadd_ps(x, y, _mm_setzero_ps()); }));
+    kernels.emplace_back(make_kernel<double, __m128d>("fma", "SSE", 1, [](__m128d x, __m128d y) { return _mm_fmadd_pd(x, y, _mm_setzero_pd()); }));
+    kernels.emplace_back(make_kernel<float, __m256>("fma", "AVX2", 1, [](__m256 x, __m256 y) { return _mm256_fmadd_ps(x, y, _mm256_setzero_ps()); }));
+    kernels.emplace_back(make_kernel<double, __m256d>("fma", "AVX2", 1, [](__m256d x, __m256d y) { return _mm256_fmadd_pd(x, y, _mm256_setzero_pd()); }));
+#endif
+#if defined(__AVX512F__)
+    kernels.emplace_back(make_kernel<float, __m512>("fma", "AVX-512", 1, [](__m512 x, __m512 y) { return _mm512_fmadd_ps(x, y, _mm512_setzero_ps()); }));
+    kernels.emplace_back(make_kernel<double, __m512d>("fma", "AVX-512", 1, [](__m512d x, __m512d y) { return _mm512_fmadd_pd(x, y, _mm512_setzero_pd()); }));
+#endif
+
+    // div, x / 1; vector integer division has no hardware instruction,
+    // it is measured separately in "division" section of the sample
+    kernels.emplace_back(make_kernel<i32, i32>("div", "scalar", 1, [](i32 x, i32 y) { return x / y; }));
+    kernels.emplace_back(make_kernel<i64, i64>("div", "scalar", 1, [](i64 x, i64 y) { return x / y; }));
+    kernels.emplace_back(make_kernel<float, float>("div", "scalar", 1, [](float x, float y) { return x / y; }));
+    kernels.emplace_back(make_kernel<double, double>("div", "scalar", 1, [](double x, double y) { return x / y; }));
+    kernels.emplace_back(make_kernel<float, __m128>("div", "SSE", 1, [](__m128 x, __m128 y) { return _mm_div_ps(x, y); }));
+    kernels.emplace_back(make_kernel<double, __m128d>("div", "SSE", 1, [](__m128d x, __m128d y) { return _mm_div_pd(x, y); }));
+#if defined(__AVX2__)
+    kernels.emplace_back(make_kernel<float, __m256>("div", "AVX2", 1, [](__m256 x, __m256 y) { return _mm256_div_ps(x, y); }));
+    kernels.emplace_back(make_kernel<double, __m256d>("div", "AVX2", 1, [](__m256d x, __m256d y) { return _mm256_div_pd(x, y); }));
+#endif
+#if defined(__AVX512F__)
+    kernels.emplace_back(make_kernel<float, __m512>("div", "AVX-512", 1, [](__m512 x, __m512 y) { return _mm512_div_ps(x, y); }));
+    kernels.emplace_back(make_kernel<double, __m512d>("div", "AVX-512", 1, [](__m512d x, __m512d y) { return _mm512_div_pd(x, y); }));
+#endif
+
+    // sqrt, chain converges to 1 and stays there
+    kernels.emplace_back(make_kernel<float, __m128>("sqrt", "scalar", 0, [](__m128 x, __m128) { return _mm_sqrt_ss(x); }));
+    kernels.emplace_back(make_kernel<double, __m128d>("sqrt", "scalar", 0, [](__m128d x, __m128d) { return _mm_sqrt_sd(x, x); }));
+    kernels.emplace_back(make_kernel<float, __m128>("sqrt", "SSE", 0, [](__m128 x, __m128) { return _mm_sqrt_ps(x); }));
+    kernels.emplace_back(make_kernel<double, __m128d>("sqrt", "SSE", 0, [](__m128d x, __m128d) { return _mm_sqrt_pd(x); }));
+#if defined(__AVX2__)
+    kernels.emplace_back(make_kernel<float, __m256>("sqrt", "AVX2", 0, [](__m256 x, __m256) { return _mm256_sqrt_ps(x); }));
+    kernels.emplace_back(make_kernel<double, __m256d>("sqrt", "AVX2", 0, [](__m256d x, __m256d) { return _mm256_sqrt_pd(x); }));
+#endif
+#if defined(__AVX512F__)
+    kernels.emplace_back(make_kernel<float, __m512>("sqrt", "AVX-512", 0, [](__m512 x, __m512) { return _mm512_mask_sqrt_ps(x, ALL_LANES_16, x); }));
+    kernels.emplace_back(make_kernel<double, __m512d>("sqrt", "AVX-512", 0, [](__m512d x, __m512d) { return _mm512_mask_sqrt_pd(x, ALL_LANES_8, x); }));
+#endif
+
+    // shuffle, in-lane permutation reversing elements (or swapping 64-bit halves) of every 128-bit lane
+    kernels.emplace_back(make_kernel<i32, __m128i>("shuffle", "SSE", 0, [](__m128i x, __m128i) { return _mm_shuffle_epi32(x, 0x1B); }));
+    kernels.emplace_back(make_kernel<i64, __m128i>("shuffle", "SSE", 0, [](__m128i x, __m128i) { return _mm_shuffle_epi32(x, 0x4E); }));
+    kernels.emplace_back(make_kernel<float, __m128>("shuffle", "SSE", 0, [](__m128 x, __m128) { return _mm_shuffle_ps(x, x, 0x1B); }));
+    kernels.emplace_back(make_kernel<double, __m128d>("shuffle", "SSE", 0, [](__m128d x, __m128d) { return _mm_shuffle_pd(x, x, 0x1); }));
+#if defined(__AVX2__)
+    kernels.emplace_back(make_kernel<i32, __m256i>("shuffle", "AVX2", 0, [](__m256i x, __m256i) { return _mm256_shuffle_epi32(x, 0x1B); }));
+    kernels.emplace_back(make_kernel<i64, __m256i>("shuffle", "AVX2", 0, [](__m256i x, __m256i) { return _mm256_shuffle_epi32(x, 0x4E); }));
+    kernels.emplace_back(make_kernel<float, __m256>("shuffle", "AVX2", 0, [](__m256 x, __m256) { return _mm256_shuffle_ps(x, x, 0x1B); }));
+    kernels.emplace_back(make_kernel<double, __m256d>("shuffle", "AVX2", 0, [](__m256d x, __m256d) { return _mm256_shuffle_pd(x, x, 0x5); }));
+#endif
+#if defined(__AVX512F__)
+    kernels.emplace_back(make_kernel<i32, __m512i>("shuffle", "AVX-512", 0, [](__m512i x, __m512i) { return _mm512_mask_shuffle_epi32(x, ALL_LANES_16, x, static_cast<_MM_PERM_ENUM>(0x1B)); }));
+    kernels.emplace_back(make_kernel<i64, __m512i>("shuffle", "AVX-512", 0, [](__m512i x, __m512i) { return _mm512_mask_shuffle_epi32(x, ALL_LANES_16, x, static_cast<_MM_PERM_ENUM>(0x4E)); }));
+    kernels.emplace_back(make_kernel<float, __m512>("shuffle", "AVX-512", 0, [](__m512 x, __m512) { return _mm512_shuffle_ps(x, x, 0x1B); }));
+    kernels.emplace_back(make_kernel<double, __m512d>("shuffle", "AVX-512", 0, [](__m512d x, __m512d) { return _mm512_shuffle_pd(x, x, 0x55); }));
+#endif
+
+    // gather, indices of the next gather are the values loaded by the previous one
+    // (for float and double their bit patterns are used); scalar gather is an indexed load
+    kernels.emplace_back(make_gather_kernel<i32, i32>("scalar", [](i32 x, i32) { return gather_table<i32>()[x]; }));
+    kernels.emplace_back(make_gather_kernel<i64, i64>("scalar", [](i64 x, i64) { return gather_table<i64>()[x]; }));
+#if defined(__AVX2__)
+    kernels.emplace_back(make_gather_kernel<i32, __m128i>("SSE", [](__m128i x, __m128i)
+    {
+        return _mm_i32gather_epi32(reinterpret_cast<const int*>(gather_table<i32>()), x, sizeof(i32));
+    }));
+    kernels.emplace_back(make_gather_kernel<i64, __m128i>("SSE", [](__m128i x, __m128i)
+    {
+        return _mm_i64gather_epi64(reinterpret_cast<const long long*>(gather_table<i64>()), x, sizeof(i64));
+    }));
+    kernels.emplace_back(make_gather_kernel<float, __m128>("SSE", [](__m128 x, __m128)
+    {
+        return _mm_i32gather_ps(gather_table<float>(), _mm_castps_si128(x), sizeof(float));
+    }));
+    kernels.emplace_back(make_gather_kernel<double, __m128d>("SSE", [](__m128d x, __m128d)
+    {
+        return _mm_i64gather_pd(gather_table<double>(), _mm_castpd_si128(x), sizeof(double));
+    }));
+    kernels.emplace_back(make_gather_kernel<i32, __m256i>("AVX2", [](__m256i x, __m256i)
+    {
+        return _mm256_i32gather_epi32(reinterpret_cast<const int*>(gather_table<i32>()), x, sizeof(i32));
+    }));
+    kernels.emplace_back(make_gather_kernel<i64, __m256i>("AVX2", [](__m256i x, __m256i)
+    {
+        return _mm256_i64gather_epi64(reinterpret_cast<const long long*>(gather_table<i64>()), x, sizeof(i64));
+    }));
+    kernels.emplace_back(make_gather_kernel<float, __m256>("AVX2", [](__m256 x, __m256)
+    {
+        return _mm256_i32gather_ps(gather_table<float>(), _mm256_castps_si256(x), sizeof(float));
+    }));
+    kernels.emplace_back(make_gather_kernel<double, __m256d>("AVX2", [](__m256d x, __m256d)
+    {
+        return _mm256_i64gather_pd(gather_table<double>(), _mm256_castpd_si256(x), sizeof(double));
+    }));
+#endif
+#if defined(__AVX512F__)
+    kernels.emplace_back(make_gather_kernel<i32, __m512i>("AVX-512", [](__m512i x, __m512i)
+    {
+        return _mm512_mask_i32gather_epi32(x, ALL_LANES_16, x, gather_table<i32>(), sizeof(i32));
+    }));
+    kernels.emplace_back(make_gather_kernel<i64, __m512i>("AVX-512", [](__m512i x, __m512i)
+    {
+        return _mm512_mask_i64gather_epi64(x, ALL_LANES_8, x, gather_table<i64>(), sizeof(i64));
+    }));
+    kernels.emplace_back(make_gather_kernel<float, __m512>("AVX-512", [](__m512 x, __m512)
+    {
+        return _mm512_mask_i32gather_ps(x, ALL_LANES_16, _mm512_castps_si512(x), gather_table<float>(), sizeof(float));
+    }));
+    kernels.emplace_back(make_gather_kernel<double, __m512d>("AVX-512", [](__m512d x, __m512d)
+    {
+        return _mm512_mask_i64gather_pd(x, ALL_LANES_8, _mm512_castpd_si512(x), gather_table<double>(), sizeof(double));
+    }));
+#endif
+
+    return kernels;
+}
+
+}  // namespace
+
+std::string_view to_string(Mode mode)
+{
+    switch (mode)
+    {
+    case Mode::LATENCY:
+        return "latency";
+    case Mode::THROUGHPUT:
+        return "throughput";
+    }
+    return "unknown";
+}
+
+const std::vector<InstructionKernel>& instruction_kernels()
+{
+    static const std::vector<InstructionKernel> kernels = make_instruction_kernels();
+    return kernels;
+}
+
+std::string enabled_extensions()
+{
+    std::string extensions = "SSE2";
+#if defined(__SSE4_1__)
+    extensions += " SSE4.1";
+#endif
+#if defined(__AVX__)
+    extensions += " AVX";
+#endif
+#if defined(__AVX2__)
+    extensions += " AVX2";
+#endif
+#if defined(__FMA__)
+    extensions += " FMA";
+#endif
+#if defined(__AVX512F__)
+    extensions += " AVX-512F";
+#endif
+#if defined(__AVX512DQ__)
+    extensions += " AVX-512DQ";
+#endif
+#if defined(__AVX512VL__)
+    extensions += " AVX-512VL";
+#endif
+    return extensions;
+}
+
+}  // namespace my::intrinsics
@@ -1,4 +1,7 @@
 #include <benchmark.hpp>
+#include <division.hpp>
+#include <instructions.hpp>
+#include <topology.hpp>
 
 #include <immintrin.h>
 
@@ -9,8 +12,12 @@
 #include <iomanip>
 #include <iostream>
 #include <limits>
+#include <memory>
 #include <string>
 #include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
 
 namespace
 {
@@ -29,6 +36,8 @@ my::TicksAndNanoseconds independent_scalar_operation(std::int64_t n1, std::int64
         my::Timer timer(result, ITERATIONS_COUNT);
         for (std::size_t i = 0; i < ITERATIONS_COUNT; ++i)
         {
+            // Otherwise loop-invariant division is hoisted out of the loop
+            my::keep_in_register(n1);
             std::int64_t n3 = n1 / n2;
             my::do_not_optimize(n3);
         }
@@ -61,7 +70,9 @@ void put_scalar_into_vector(std::int64_t scalar, __m256i& vector)
     std::memcpy(&vector, array, sizeof(vector));
 }
 
-my::TicksAndNanoseconds independent_vector_operation(std::int64_t n1, std::int64_t n2)
+// Divide takes (dividends, divisors) and returns quotients
+template <typename Divide>
+my::TicksAndNanoseconds independent_vector_operation(std::int64_t n1, std::int64_t n2, Divide divide)
 {
     asm volatile("# independent_vector_operation enter\n");
 
@@ -75,7 +86,10 @@ my::TicksAndNanoseconds independent_vector_operation(std::int64_t n1, std::int64
         my::Timer timer(result, ITERATIONS_COUNT);
         for (std::size_t i = 0; i < vector_iterations_count; ++i)
         {
-            __m256i v3 = _mm256_div_epi64(v1, v2);
+            // Inlined divisions must not be hoisted out of the loop (partially or entirely)
+            my::keep_in_register(v1);
+            my::keep_in_register(v2);
+            __m256i v3 = divide(v1, v2);
             my::do_not_optimize(v3);
         }
     }
@@ -83,7 +97,8 @@ my::TicksAndNanoseconds independent_vector_operation(std::int64_t n1, std::int64
     return result;
 }
 
-my::TicksAndNanoseconds dependent_vector_operation(std::int64_t n1, std::int64_t n2)
+template <typename Divide>
+my::TicksAndNanoseconds dependent_vector_operation(std::int64_t n1, std::int64_t n2, Divide divide)
 {
     asm volatile("# dependent_vector_operation enter\n");
 
@@ -97,7 +112,8 @@ my::TicksAndNanoseconds dependent_vector_operation(std::int64_t n1, std::int64_t
         my::Timer timer(result, ITERATIONS_COUNT);
         for (std::size_t i = 0; i < vector_iterations_count; ++i)
         {
-            v1 = _mm256_div_epi64(v1, v2);
+            my::keep_in_register(v2);
+            v1 = divide(v1, v2);
         }
         my::do_not_optimize(v1);
     }
@@ -105,6 +121,48 @@ my::TicksAndNanoseconds dependent_vector_operation(std::int64_t n1, std::int64_t
     return result;
 }
 
+#if defined(__INTEL_COMPILER) || defined(__INTEL_LLVM_COMPILER)
+__m256i svml_divide(__m256i a, __m256i b)
+{
+    return _mm256_div_epi64(a, b);
+}
+#endif
+
+__m256i general_divide(__m256i a, __m256i b)
+{
+    return my::intrinsics::div_epi64(a, b);
+}
+
+// Compares vector division with scalar one on CLI-arguments and a few corner cases
+void check_division(std::int64_t n1, std::int64_t n2)
+{
+    static constexpr std::int64_t MIN = std::numeric_limits<std::int64_t>::min();
+    static constexpr std::int64_t MAX = std::numeric_limits<std::int64_t>::max();
+    const std::int64_t dividends[] = { n1, (n1 == MIN ? 0 : -n1), 0, 1, -1, MAX, MIN + 1, n2 };
+
+    my::intrinsics::InvariantDivisor divisor(n2);
+    for (std::int64_t dividend : dividends)
+    {
+        __m256i v1, v2;
+        put_scalar_into_vector(dividend, v1);
+        put_scalar_into_vector(n2, v2);
+
+        std::int64_t expected = dividend / n2;
+        std::int64_t general[SCALARS_IN_VECTOR];
+        std::int64_t invariant[SCALARS_IN_VECTOR];
+        __m256i general_vector = general_divide(v1, v2);
+        __m256i invariant_vector = divisor.divide(v1);
+        std::memcpy(general, &general_vector, sizeof(general));
+        std::memcpy(invariant, &invariant_vector, sizeof(invariant));
+        if (general[0] != expected || invariant[0] != expected)
+        {
+            throw std::runtime_error("Error: vector division of " + std::to_string(dividend) + " by " + std::to_string(n2) +
+                                     " returned " + std::to_string(general[0]) + " (general) and " +
+                                     std::to_string(invariant[0]) + " (invariant), expected " + std::to_string(expected));
+        }
+    }
+}
+
 struct Params
 {
     std::int64_t n1;
@@ -113,7 +171,8 @@ struct Params
 
 Params parse_cmd_line(int argc, char* argv[])
 {
-    if (argc != 3)
+    std::vector<std::string> args = my::positional_cmd_line_args(argc, argv);
+    if (args.size() != 2)
     {
         throw std::invalid_argument("Error: you must pass 2 integers as CLI-arguments");
     }
@@ -140,16 +199,137 @@ Params parse_cmd_line(int argc, char* argv[])
         }
     };
 
-    return Params{ .n1 = int_from_string(std::string(argv[1])),
-                   .n2 = int_from_string(std::string(argv[2])) };
+    Params params{ .n1 = int_from_string(args[0]),
+                   .n2 = int_from_string(args[1]) };
+    if (params.n2 == 0 || (params.n1 == std::numeric_limits<std::int64_t>::min() && params.n2 == -1))
+    {
+        throw std::invalid_argument("Error: quotient of " + args[0] + " and " + args[1] + " is undefined");
+    }
+    return params;
 }
 
-void print_table_row(std::string_view label, my::TicksAndNanoseconds result)
+// Human-readable layout of OutputFormat::TEXT
+class DivisionTableResultSink : public my::ResultSink
+{
+public:
+    DivisionTableResultSink()
+    {
+        const my::TscClock& tsc = my::TscClock::get_instance();
+        std::cout << "TSC: " << (tsc.invariant() ? "invariant" : "NOT invariant") << ", "
+                  << std::setprecision(3) << std::fixed << tsc.ticks_per_nanosecond() << " ticks / ns, "
+                  << tsc.overhead() << " ticks of timer overhead subtracted" << std::endl;
+        std::cout << std::defaultfloat;
+        std::cout << SEPARATOR << std::endl
+                  << "|       operation       | ticks / iter | ns / iter |" << std::endl
+                  << SEPARATOR << std::endl;
+    }
+
+    void write(const my::BenchmarkRecord& record) override
+    {
+        static constexpr std::size_t LABEL_WIDTH = 21;
+        std::size_t padding = LABEL_WIDTH > record.name.size() ? LABEL_WIDTH - record.name.size() : 0;
+        std::string label = std::string(padding / 2, ' ') + record.name + std::string(padding - padding / 2, ' ');
+
+        std::cout << "| " << label << " | "
+                  << std::setw(12) << record.result.ticks.median << " | "
+                  << std::setw(9)  << record.result.nanoseconds.median << " |" << std::endl
+                  << SEPARATOR << std::endl;
+    }
+
+private:
+    static constexpr std::string_view SEPARATOR = "+-----------------------+--------------+-----------+";
+};
+
+// Human-readable layout of OutputFormat::TEXT for the instruction matrix
+class InstructionTableResultSink : public my::ResultSink
 {
-    std::cout << "| " << label << " | "
-              << std::setw(12) << result.ticks << " | "
-              << std::setw(9)  << result.nanoseconds << " |" << std::endl
-              << "+--------------------+--------------+-----------+" << std::endl;
+public:
+    InstructionTableResultSink()
+    {
+        std::cout << std::endl
+                  << "Instruction set extensions: " << my::intrinsics::enabled_extensions() << std::endl
+                  << "Throughput is reciprocal: ticks per instruction with "
+                  << my::intrinsics::THROUGHPUT_CHAINS_COUNT << " independent chains" << std::endl
+                  << SEPARATOR << std::endl
+                  << "| operation |  type  |  width  |    mode    | ticks / instr | ns / instr |" << std::endl
+                  << SEPARATOR << std::endl;
+    }
+
+    void write(const my::BenchmarkRecord& record) override
+    {
+        std::cout << "| " << std::setw(9) << param(record, "operation") << " | "
+                  << std::setw(6) << param(record, "type") << " | "
+                  << std::setw(7) << param(record, "width") << " | "
+                  << std::setw(10) << param(record, "mode") << " | "
+                  << std::setw(13) << std::setprecision(2) << std::fixed << record.result.ticks.median << " | "
+                  << std::setw(10) << std::setprecision(2) << std::fixed << record.result.nanoseconds.median << " |" << std::endl;
+        std::cout << std::defaultfloat;
+        if (param(record, "mode") == my::intrinsics::to_string(my::intrinsics::Mode::THROUGHPUT))
+        {
+            std::cout << SEPARATOR << std::endl;
+        }
+    }
+
+private:
+    static std::string param(const my::BenchmarkRecord& record, std::string_view name)
+    {
+        for (const auto& [key, value] : record.params)
+        {
+            if (key == name)
+            {
+                return std::get<std::string>(value);
+            }
+        }
+        return {};
+    }
+
+    static constexpr std::string_view SEPARATOR = "+-----------+--------+---------+------------+---------------+------------+";
+};
+
+// Each operation is measured as one long sample
+my::BenchmarkRecord make_record(std::string name, const Params& params, my::TicksAndNanoseconds result)
+{
+    const my::TscClock& tsc = my::TscClock::get_instance();
+    return { .name = std::move(name),
+             .params = { { "n1", params.n1 },
+                         { "n2", params.n2 },
+                         { "iterations", static_cast<std::int64_t>(ITERATIONS_COUNT) },
+                         { "tsc_invariant", std::int64_t{ tsc.invariant() } },
+                         { "tsc_ticks_per_ns", tsc.ticks_per_nanosecond() } },
+             .result = { .ticks = my::compute_statistics({ result.ticks }, false),
+                         .nanoseconds = my::compute_statistics({ result.nanoseconds }, false) } };
+}
+
+my::BenchmarkRecord measure_instruction(const my::intrinsics::InstructionKernel& kernel, my::intrinsics::Mode mode)
+{
+    static constexpr std::size_t WARMUP_COUNT = 2;
+    static constexpr std::size_t SAMPLES_COUNT = 20;
+    static constexpr std::size_t STEPS_COUNT = 100'000;
+
+    for (std::size_t i = 0; i < WARMUP_COUNT; ++i)
+    {
+        kernel.measure(mode, STEPS_COUNT);
+    }
+
+    std::vector<double> ticks;
+    std::vector<double> nanoseconds;
+    for (std::size_t i = 0; i < SAMPLES_COUNT; ++i)
+    {
+        my::TicksAndNanoseconds sample = kernel.measure(mode, STEPS_COUNT);
+        ticks.emplace_back(sample.ticks);
+        nanoseconds.emplace_back(sample.nanoseconds);
+    }
+
+    std::size_t chains_count = (mode == my::intrinsics::Mode::LATENCY ? 1 : my::intrinsics::THROUGHPUT_CHAINS_COUNT);
+    return { .name = std::string(kernel.operation) + " " + std::string(kernel.type) + " " + std::string(kernel.width),
+             .params = { { "operation", std::string(kernel.operation) },
+                         { "type", std::string(kernel.type) },
+                         { "width", std::string(kernel.width) },
+                         { "mode", std::string(my::intrinsics::to_string(mode)) },
+                         { "chains", static_cast<std::int64_t>(chains_count) },
+                         { "steps", static_cast<std::int64_t>(STEPS_COUNT) } },
+             .result = { .ticks = my::compute_statistics(std::move(ticks)),
+                         .nanoseconds = my::compute_statistics(std::move(nanoseconds)) } };
 }
 
 }  // namespace
@@ -157,19 +337,55 @@ void print_table_row(std::string_view label, my::TicksAndNanoseconds result)
 int main(int argc, char* argv[]) try
 {
     Params params = parse_cmd_line(argc, argv);
+    check_division(params.n1, params.n2);
+
+    if (!my::TscClock::get_instance().invariant())
+    {
+        std::cerr << "Warning: TSC is not invariant, ticks are not proportional to time" << std::endl;
+    }
+
+    my::OutputFormat format = my::output_format_from_cmd_line(argc, argv);
+    my::topology::Pinning pinning = my::topology::pinning_from_string(my::find_cmd_line_option(argc, argv, "pin").value_or("none"));
+
+    my::topology::Topology topology = my::topology::Topology::detect();
+    std::vector<int> placement = my::topology::make_placement(topology, pinning, 1);
+    if (!placement.empty())
+    {
+        my::topology::pin_current_thread(placement.front());
+    }
+    my::header_stream(format) << "Topology: " << topology.describe() << std::endl
+                              << "Pinning: " << my::topology::to_string(pinning.policy)
+                              << ", running on cpu " << my::topology::current_cpu() << std::endl;
+
+    std::unique_ptr<my::ResultSink> sink = (format == my::OutputFormat::TEXT ? std::make_unique<DivisionTableResultSink>()
+                                                                           : my::make_result_sink(format, "intrinsics"));
 
-    my::TicksAndNanoseconds independent_scalar_result = independent_scalar_operation(params.n1, params.n2);
-    my::TicksAndNanoseconds dependent_scalar_result = dependent_scalar_operation(params.n1, params.n2);
-    my::TicksAndNanoseconds independent_vector_result = independent_vector_operation(params.n1, params.n2);
-    my::TicksAndNanoseconds dependent_vector_result = dependent_vector_operation(params.n1, params.n2);
-
-    std::cout << "+--------------------+--------------+-----------+" << std::endl
-              << "|      operation     | ticks / iter | ns / iter |" << std::endl
-              << "+--------------------+--------------+-----------+" << std::endl;
-    print_table_row("independent scalar", independent_scalar_result);
-    print_table_row(" dependent scalar ", dependent_scalar_result);
-    print_table_row("independent vector", independent_vector_result);
-    print_table_row(" dependent vector ", dependent_vector_result);
+    sink->write(make_record("independent scalar", params, independent_scalar_operation(params.n1, params.n2)));
+    sink->write(make_record("dependent scalar", params, dependent_scalar_operation(params.n1, params.n2)));
+#if defined(__INTEL_COMPILER) || defined(__INTEL_LLVM_COMPILER)
+    sink->write(make_record("independent SVML", params, independent_vector_operation(params.n1, params.n2, svml_divide)));
+    sink->write(make_record("dependent SVML", params, dependent_vector_operation(params.n1, params.n2, svml_divide)));
+#endif
+    sink->write(make_record("independent general", params, independent_vector_operation(params.n1, params.n2, general_divide)));
+    sink->write(make_record("dependent general", params, dependent_vector_operation(params.n1, params.n2, general_divide)));
+
+    my::intrinsics::InvariantDivisor divisor(params.n2);
+    auto invariant_divide = [&divisor](__m256i a, __m256i)
+    {
+        return divisor.divide(a);
+    };
+    sink->write(make_record("independent invariant", params, independent_vector_operation(params.n1, params.n2, invariant_divide)));
+    sink->write(make_record("dependent invariant", params, dependent_vector_operation(params.n1, params.n2, invariant_divide)));
+
+    if (format == my::OutputFormat::TEXT)
+    {
+        sink = std::make_unique<InstructionTableResultSink>();
+    }
+    for (const my::intrinsics::InstructionKernel& kernel : my::intrinsics::instruction_kernels())
+    {
+        sink->write(measure_instruction(kernel, my::intrinsics::Mode::LATENCY));
+        sink->write(measure_instruction(kernel, my::intrinsics::Mode::THROUGHPUT));
+    }
 
     return EXIT_SUCCESS;
 }
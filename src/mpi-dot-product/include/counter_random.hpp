@@ -0,0 +1,88 @@
+#ifndef PARALLEL_COMPUTING_MPI_DOT_PRODUCT_COUNTER_RANDOM_HPP_
+#define PARALLEL_COMPUTING_MPI_DOT_PRODUCT_COUNTER_RANDOM_HPP_
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+// Counter-based random numbers: the value for an index is a function of the index and the key
+// only (Philox4x32-10, J. K. Salmon et al., "Parallel random numbers: as easy as 1, 2, 3", 2011),
+// so any process can generate any part of a sequence without generating the preceding values
+// and the result does not depend on how the sequence is split between processes.
+
+namespace my::random
+{
+
+class Philox4x32
+{
+public:
+    using counter_t = std::array<std::uint32_t, 4>;
+    using key_t = std::array<std::uint32_t, 2>;
+
+    static constexpr int ROUNDS_COUNT = 10;
+
+    static constexpr counter_t apply(counter_t counter, key_t key)
+    {
+        for (int round = 0; round < ROUNDS_COUNT; ++round)
+        {
+            if (round != 0)
+            {
+                key[0] += W0;
+                key[1] += W1;
+            }
+            std::uint64_t product0 = std::uint64_t{ M0 } * counter[0];
+            std::uint64_t product1 = std::uint64_t{ M1 } * counter[2];
+            counter = { static_cast<std::uint32_t>(product1 >> 32) ^ counter[1] ^ key[0],
+                        static_cast<std::uint32_t>(product1),
+                        static_cast<std::uint32_t>(product0 >> 32) ^ counter[3] ^ key[1],
+                        static_cast<std::uint32_t>(product0) };
+        }
+        return counter;
+    }
+
+private:
+    static constexpr std::uint32_t M0 = 0xD2511F53;
+    static constexpr std::uint32_t M1 = 0xCD9E8D57;
+    static constexpr std::uint32_t W0 = 0x9E3779B9;
+    static constexpr std::uint32_t W1 = 0xBB67AE85;
+};
+
+// Known answer from the Random123 test vectors
+static_assert(Philox4x32::apply({ 0, 0, 0, 0 }, { 0, 0 }) == Philox4x32::counter_t{ 0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8 });
+
+// Uniformly distributed doubles in [min, max) addressed by (stream, index): different streams
+// of the same seed give independent sequences, e.g. for different vectors
+class UniformRealSequence
+{
+public:
+    UniformRealSequence(std::uint64_t seed, std::uint32_t stream, double min, double max)
+        : m_key{ static_cast<std::uint32_t>(seed), static_cast<std::uint32_t>(seed >> 32) }
+        , m_stream(stream)
+        , m_min(min)
+        , m_scale(max - min)
+        , m_last(std::nextafter(max, min))
+    {
+    }
+
+    double operator()(std::uint64_t index) const
+    {
+        Philox4x32::counter_t bits = Philox4x32::apply({ static_cast<std::uint32_t>(index), static_cast<std::uint32_t>(index >> 32), m_stream, 0 }, m_key);
+        // 53 random bits give every double of [0, 1) with step 2^-53
+        std::uint64_t mantissa = ((std::uint64_t{ bits[0] } << 32) | bits[1]) >> 11;
+        // min + scale * u may round up to max for u close to 1
+        return std::min(m_min + m_scale * (static_cast<double>(mantissa) * 0x1.0p-53), m_last);
+    }
+
+private:
+    Philox4x32::key_t m_key;
+    std::uint32_t m_stream;
+    double m_min;
+    double m_scale;
+    // The largest double below max
+    double m_last;
+};
+
+}  // namespace my::random
+
+#endif  // PARALLEL_COMPUTING_MPI_DOT_PRODUCT_COUNTER_RANDOM_HPP_
@@ -0,0 +1,159 @@
+#ifndef PARALLEL_COMPUTING_MPI_DOT_PRODUCT_DISTRIBUTED_VECTOR_HPP_
+#define PARALLEL_COMPUTING_MPI_DOT_PRODUCT_DISTRIBUTED_VECTOR_HPP_
+
+#include <mpi.hpp>
+
+#include <boost/container/vector.hpp>
+
+#include <algorithm>
+#include <cstddef>
+
+// A vector split into contiguous blocks between all processes of my::mpi::COMM. Every
+// process keeps only its block, which is created once, so operations on vectors that
+// stay in place (e.g. in iterative solvers) communicate only their scalar results.
+// Blocks are generated in place from global indices, so setup needs no communication either.
+
+namespace my::distributed
+{
+
+// Block partition of size elements into blocks of whole units of alignment elements (except
+// for the last one): the first processes get one unit more than the others
+class Partition
+{
+public:
+    Partition(std::size_t size, std::size_t process_count, std::size_t alignment = 1)
+        : m_size(size)
+        , m_alignment(alignment)
+        , m_quotient(units_count() / process_count)
+        , m_remainder(units_count() % process_count)
+    {
+    }
+
+    std::size_t size() const
+    {
+        return m_size;
+    }
+
+    std::size_t offset(std::size_t process_id) const
+    {
+        std::size_t units_offset;
+        if (process_id <= m_remainder)
+        {
+            units_offset = (m_quotient + 1) * process_id;
+        }
+        else
+        {
+            units_offset = (m_quotient + 1) * m_remainder + m_quotient * (process_id - m_remainder);
+        }
+        return std::min(units_offset * m_alignment, m_size);
+    }
+
+    std::size_t count(std::size_t process_id) const
+    {
+        return offset(process_id + 1) - offset(process_id);
+    }
+
+private:
+    std::size_t units_count() const
+    {
+        return (m_size + m_alignment - 1) / m_alignment;
+    }
+
+    std::size_t m_size;
+    std::size_t m_alignment;
+    std::size_t m_quotient;
+    std::size_t m_remainder;
+};
+
+// Reproducible dot products add up sums of chunks of this many elements in the order of
+// chunks, so local blocks of distributed vectors consist of whole chunks
+inline constexpr std::size_t REPRODUCIBLE_CHUNK_SIZE = 1 << 12;
+
+class DistributedVector
+{
+public:
+    // Collective: scatters data of size elements, which is read on root only
+    static DistributedVector scatter(const double* data, std::size_t size);
+
+    // Fills the local block in place with generator(i) for every global index i of the block,
+    // no communication is needed. OpenMP threads of the process fill their parts of the block,
+    // so generator must be safe to call concurrently.
+    template <typename Generator>
+    static DistributedVector generate(std::size_t size, Generator generator)
+    {
+        DistributedVector vector(size);
+        std::size_t local_size = vector.local_size();
+        #pragma omp parallel for schedule(static)
+        for (std::size_t i = 0; i < local_size; ++i)
+        {
+            vector.m_local[i] = generator(vector.offset() + i);
+        }
+        return vector;
+    }
+
+    // Global size of the vector
+    std::size_t size() const
+    {
+        return m_partition.size();
+    }
+
+    // Global index of the first element of the local block
+    std::size_t offset() const
+    {
+        return m_offset;
+    }
+
+    std::size_t local_size() const
+    {
+        return m_local.size();
+    }
+
+    const double* local_data() const
+    {
+        return m_local.data();
+    }
+
+    double* local_data()
+    {
+        return m_local.data();
+    }
+
+    const Partition& partition() const
+    {
+        return m_partition;
+    }
+
+private:
+    // Allocates the local block without initialization
+    explicit DistributedVector(std::size_t size);
+
+    Partition m_partition;
+    std::size_t m_offset;
+    boost::container::vector<double> m_local;
+};
+
+// Collective: the local blocks are multiplied by OpenMP threads of every process and the partial
+// sums are added up with one MPI_Allreduce from the master thread, so every process gets the result
+double dot_product(const DistributedVector& a, const DistributedVector& b);
+
+// Sum of a[i] * b[i] over every chunk of REPRODUCIBLE_CHUNK_SIZE elements, then sum of chunk
+// sums in their order. The result is bit-identical for any number of processes.
+double dot_product_reproducible(const double* a, const double* b, std::size_t size);
+
+// Collective: every process computes the sums of its chunks, all of them are gathered with
+// MPI_Allgatherv and added up in order by every process, so the result is bit-identical to
+// the serial dot_product_reproducible of the same vectors
+double dot_product_reproducible(const DistributedVector& a, const DistributedVector& b);
+
+// Collective: one-shot dot product of vectors of size elements held by root. Block of every
+// process is scattered in rounds of chunk_size elements with MPI_Iscatterv into two buffers,
+// so that the local loop over chunk k overlaps the transfer of chunk k + 1. Partial sums are
+// added up with MPI_Reduce, the result is returned on root.
+double dot_product_pipelined(const double* a, const double* b, std::size_t size, std::size_t chunk_size);
+
+// Number of rounds of dot_product_pipelined
+std::size_t pipeline_rounds_count(std::size_t size, std::size_t chunk_size);
+
+}  // namespace my::distributed
+
+#endif  // PARALLEL_COMPUTING_MPI_DOT_PRODUCT_DISTRIBUTED_VECTOR_HPP_
@@ -0,0 +1,97 @@
+#ifndef PARALLEL_COMPUTING_MPI_DOT_PRODUCT_NODE_SHARED_VECTOR_HPP_
+#define PARALLEL_COMPUTING_MPI_DOT_PRODUCT_NODE_SHARED_VECTOR_HPP_
+
+#include <distributed_vector.hpp>
+#include <mpi.hpp>
+
+#include <cstddef>
+#include <memory>
+
+// A vector split into blocks between nodes rather than processes. The block of a node is
+// stored once in an MPI-3 shared memory window, every process of the node works on its slice
+// of the block in place. Data is sent to one process per node, so it crosses the network once
+// per node and is never copied between processes of a node.
+
+namespace my::distributed
+{
+
+// Communicators used by node shared vectors, created once for all of them
+struct NodeCommunicators
+{
+    NodeCommunicators()
+        : node(my::mpi::split_shared())
+        , leaders(my::mpi::split_node_leaders(node))
+    {
+    }
+
+    // Processes of the current node
+    my::mpi::Communicator node;
+    // Processes with rank 0 in their node, null on other processes
+    my::mpi::Communicator leaders;
+};
+
+class NodeSharedVector
+{
+public:
+    // Collective: scatters data of size elements, which is read on root only, between node leaders
+    static NodeSharedVector scatter(const NodeCommunicators& communicators, const double* data, std::size_t size);
+
+    // Collective: every process fills its slice in place with generator(i) for every global index i
+    template <typename Generator>
+    static NodeSharedVector generate(const NodeCommunicators& communicators, std::size_t size, Generator generator)
+    {
+        NodeSharedVector vector(communicators, size);
+        double* local = vector.m_node_data + (vector.m_offset - vector.m_node_offset);
+        std::size_t local_size = vector.local_size();
+        #pragma omp parallel for schedule(static)
+        for (std::size_t i = 0; i < local_size; ++i)
+        {
+            local[i] = generator(vector.offset() + i);
+        }
+        vector.m_window->synchronize();
+        return vector;
+    }
+
+    // Global size of the vector
+    std::size_t size() const
+    {
+        return m_size;
+    }
+
+    // Global index of the first element of the slice of the current process
+    std::size_t offset() const
+    {
+        return m_offset;
+    }
+
+    std::size_t local_size() const
+    {
+        return m_local_size;
+    }
+
+    // Slice of the current process in the shared block of the node
+    const double* local_data() const
+    {
+        return m_node_data + (m_offset - m_node_offset);
+    }
+
+private:
+    // Allocates the shared block of the node without initialization
+    NodeSharedVector(const NodeCommunicators& communicators, std::size_t size);
+
+    std::unique_ptr<my::mpi::SharedWindow> m_window;
+    double* m_node_data;
+    std::size_t m_size;
+    std::size_t m_node_offset;
+    std::size_t m_node_size;
+    std::size_t m_offset;
+    std::size_t m_local_size;
+};
+
+// Collective: every process multiplies its slices with OpenMP threads and the partial sums
+// are added up with one MPI_Allreduce over my::mpi::COMM
+double dot_product(const NodeSharedVector& a, const NodeSharedVector& b);
+
+}  // namespace my::distributed
+
+#endif  // PARALLEL_COMPUTING_MPI_DOT_PRODUCT_NODE_SHARED_VECTOR_HPP_
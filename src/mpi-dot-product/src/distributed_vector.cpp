@@ -0,0 +1,241 @@
+#include <distributed_vector.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace my::distributed
+{
+
+namespace bc = boost::container;
+
+namespace
+{
+
+std::size_t chunks_count(std::size_t size)
+{
+    return (size + REPRODUCIBLE_CHUNK_SIZE - 1) / REPRODUCIBLE_CHUNK_SIZE;
+}
+
+// Sums of a[i] * b[i] in chunks of REPRODUCIBLE_CHUNK_SIZE elements, both serial and distributed
+// variants use this function, so chunk sums are computed by the same code. Chunks are shared
+// between OpenMP threads, but every chunk is summed in order by one thread.
+void chunk_sums(const double* a, const double* b, std::size_t size, double* sums)
+{
+    std::size_t count = chunks_count(size);
+    #pragma omp parallel for schedule(static)
+    for (std::size_t chunk = 0; chunk < count; ++chunk)
+    {
+        std::size_t first = chunk * REPRODUCIBLE_CHUNK_SIZE;
+        std::size_t last = std::min(first + REPRODUCIBLE_CHUNK_SIZE, size);
+        double sum = 0;
+        for (std::size_t i = first; i < last; ++i)
+        {
+            sum += a[i] * b[i];
+        }
+        sums[chunk] = sum;
+    }
+}
+
+double ordered_sum(const double* sums, std::size_t count)
+{
+    double sum = 0;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        sum += sums[i];
+    }
+    return sum;
+}
+
+}  // namespace
+
+DistributedVector::DistributedVector(std::size_t size)
+    : m_partition(size, my::mpi::Params::get_instance().process_count(), REPRODUCIBLE_CHUNK_SIZE)
+    , m_offset(m_partition.offset(my::mpi::Params::get_instance().process_id()))
+    , m_local(m_partition.count(my::mpi::Params::get_instance().process_id()), bc::default_init_t{})
+{
+}
+
+DistributedVector DistributedVector::scatter(const double* data, std::size_t size)
+{
+    const auto& mpi_params = my::mpi::Params::get_instance();
+    DistributedVector vector(size);
+
+    bc::vector<my::mpi::Count> counts;
+    bc::vector<my::mpi::Displacement> offsets;
+    if (my::mpi::is_current_process_root())
+    {
+        counts.resize (mpi_params.process_count(), bc::default_init_t{});
+        offsets.resize(mpi_params.process_count(), bc::default_init_t{});
+
+        for (std::size_t i = 0; i < mpi_params.process_count(); ++i)
+        {
+            offsets[i] = static_cast<my::mpi::Displacement>(vector.m_partition.offset(i));
+            counts[i]  = static_cast<my::mpi::Count>(vector.m_partition.count(i));
+        }
+    }
+
+    my::mpi::Communicator::world().scatterv(my::mpi::Span(data, size), counts, offsets, my::mpi::Span(vector.m_local));
+    return vector;
+}
+
+double dot_product(const DistributedVector& a, const DistributedVector& b)
+{
+    if (a.size() != b.size())
+    {
+        throw std::invalid_argument("Distributed vectors have different sizes");
+    }
+
+    const double* a_part = a.local_data();
+    const double* b_part = b.local_data();
+    std::size_t size_part = a.local_size();
+    double dot_product_part = 0;
+    #pragma omp parallel for simd schedule(static) reduction(+ : dot_product_part)
+    for (std::size_t i = 0; i < size_part; ++i)
+    {
+        dot_product_part += a_part[i] * b_part[i];
+    }
+
+    return my::mpi::Communicator::world().allreduce(dot_product_part, MPI_SUM);
+}
+
+double dot_product_reproducible(const double* a, const double* b, std::size_t size)
+{
+    bc::vector<double> sums(chunks_count(size), bc::default_init_t{});
+    chunk_sums(a, b, size, sums.data());
+    return ordered_sum(sums.data(), sums.size());
+}
+
+double dot_product_reproducible(const DistributedVector& a, const DistributedVector& b)
+{
+    if (a.size() != b.size())
+    {
+        throw std::invalid_argument("Distributed vectors have different sizes");
+    }
+
+    const auto& mpi_params = my::mpi::Params::get_instance();
+    bc::vector<my::mpi::Count> counts(mpi_params.process_count(), bc::default_init_t{});
+    bc::vector<my::mpi::Displacement> offsets(mpi_params.process_count(), bc::default_init_t{});
+    for (std::size_t i = 0; i < mpi_params.process_count(); ++i)
+    {
+        offsets[i] = static_cast<my::mpi::Displacement>(a.partition().offset(i) / REPRODUCIBLE_CHUNK_SIZE);
+        counts[i]  = static_cast<my::mpi::Count>(chunks_count(a.partition().count(i)));
+    }
+
+    bc::vector<double> local_sums(chunks_count(a.local_size()), bc::default_init_t{});
+    chunk_sums(a.local_data(), b.local_data(), a.local_size(), local_sums.data());
+
+    bc::vector<double> sums(chunks_count(a.size()), bc::default_init_t{});
+    my::mpi::Communicator::world().allgatherv(my::mpi::Span(local_sums), my::mpi::Span(sums), counts, offsets);
+    return ordered_sum(sums.data(), sums.size());
+}
+
+std::size_t pipeline_rounds_count(std::size_t size, std::size_t chunk_size)
+{
+    if (chunk_size == 0)
+    {
+        throw std::invalid_argument("Chunk size must be positive");
+    }
+    Partition partition(size, my::mpi::Params::get_instance().process_count());
+    // The first process has the largest block
+    return (partition.count(0) + chunk_size - 1) / chunk_size;
+}
+
+double dot_product_pipelined(const double* a, const double* b, std::size_t size, std::size_t chunk_size)
+{
+    const auto& mpi_params = my::mpi::Params::get_instance();
+    std::size_t process_count = mpi_params.process_count();
+    std::size_t rounds_count = pipeline_rounds_count(size, chunk_size);
+    Partition partition(size, process_count);
+    std::size_t process_id = mpi_params.process_id();
+
+    // Counts and displacements of a round must not change until its scatters complete,
+    // so every buffer slot has its own ones
+    static constexpr std::size_t SLOTS_COUNT = 2;
+    // Without an asynchronous progress thread transfers advance only inside MPI calls,
+    // so the next round is tested after every block of this many elements
+    static constexpr std::size_t PROGRESS_BLOCK_SIZE = 1 << 14;
+    bc::vector<my::mpi::Count> counts[SLOTS_COUNT];
+    bc::vector<my::mpi::Displacement> offsets[SLOTS_COUNT];
+    bc::vector<double> a_parts[SLOTS_COUNT], b_parts[SLOTS_COUNT];
+    my::mpi::RequestSet requests[SLOTS_COUNT];
+    for (std::size_t slot = 0; slot < SLOTS_COUNT; ++slot)
+    {
+        if (my::mpi::is_current_process_root())
+        {
+            counts[slot].resize (process_count, bc::default_init_t{});
+            offsets[slot].resize(process_count, bc::default_init_t{});
+        }
+        a_parts[slot].resize(std::min(chunk_size, partition.count(process_id)), bc::default_init_t{});
+        b_parts[slot].resize(std::min(chunk_size, partition.count(process_id)), bc::default_init_t{});
+    }
+
+    auto round_count = [&partition, chunk_size](std::size_t id, std::size_t round) -> std::size_t
+    {
+        std::size_t first = round * chunk_size;
+        std::size_t count = partition.count(id);
+        return first < count ? std::min(chunk_size, count - first) : 0;
+    };
+
+    const my::mpi::Communicator world = my::mpi::Communicator::world();
+    auto start_round = [&](std::size_t round)
+    {
+        std::size_t slot = round % SLOTS_COUNT;
+        if (my::mpi::is_current_process_root())
+        {
+            for (std::size_t i = 0; i < process_count; ++i)
+            {
+                offsets[slot][i] = static_cast<my::mpi::Displacement>(partition.offset(i) + round * chunk_size);
+                counts[slot][i]  = static_cast<my::mpi::Count>(round_count(i, round));
+            }
+        }
+        std::size_t count = round_count(process_id, round);
+        requests[slot].add(world.iscatterv(my::mpi::Span(a, size), counts[slot], offsets[slot], my::mpi::Span(a_parts[slot].data(), count)));
+        requests[slot].add(world.iscatterv(my::mpi::Span(b, size), counts[slot], offsets[slot], my::mpi::Span(b_parts[slot].data(), count)));
+    };
+
+    double dot_product_part = 0;
+    if (rounds_count > 0)
+    {
+        start_round(0);
+    }
+    for (std::size_t round = 0; round < rounds_count; ++round)
+    {
+        if (round + 1 < rounds_count)
+        {
+            start_round(round + 1);
+        }
+
+        std::size_t slot = round % SLOTS_COUNT;
+        requests[slot].wait_all();
+        requests[slot] = my::mpi::RequestSet();
+
+        const double* a_part = a_parts[slot].data();
+        const double* b_part = b_parts[slot].data();
+        std::size_t size_part = round_count(process_id, round);
+        bool has_next_round = round + 1 < rounds_count;
+        my::mpi::RequestSet& next_requests = requests[(round + 1) % SLOTS_COUNT];
+        // The master thread tests the next round between blocks (MPI_THREAD_FUNNELED),
+        // the implicit barrier of the following block keeps it in step with the others
+        #pragma omp parallel reduction(+ : dot_product_part)
+        for (std::size_t first = 0; first < size_part; first += PROGRESS_BLOCK_SIZE)
+        {
+            std::size_t last = std::min(first + PROGRESS_BLOCK_SIZE, size_part);
+            #pragma omp for simd schedule(static)
+            for (std::size_t i = first; i < last; ++i)
+            {
+                dot_product_part += a_part[i] * b_part[i];
+            }
+            if (has_next_round)
+            {
+                #pragma omp master
+                next_requests.test_all();
+            }
+        }
+    }
+
+    double dot_product = 0;
+    world.reduce(my::mpi::Span(dot_product_part), my::mpi::Span(dot_product), MPI_SUM);
+    return dot_product;
+}
+
+}  // namespace my::distributed
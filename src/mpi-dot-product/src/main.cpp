@@ -1,22 +1,52 @@
 #include <benchmark.hpp>
+#include <counter_random.hpp>
+#include <distributed_vector.hpp>
 #include <mpi.hpp>
+#include <node_shared_vector.hpp>
+#include <topology.hpp>
 
 #include <boost/container/vector.hpp>
 #include <mpi.h>
+#include <omp.h>
 
-#include <algorithm>
 #include <cmath>
+#include <cstdint>
+#include <exception>
 #include <iostream>
-#include <random>
+#include <iterator>
+#include <memory>
+#include <optional>
 #include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
 
 namespace
 {
 
-static constexpr std::size_t ITERATIONS_COUNT = 100;
+static constexpr my::BenchmarkParams BENCHMARK_PARAMS = { .warmup_count = 5, .samples_count = 100 };
 
 namespace bc = boost::container;
 
+// Every element is a function of the seed, the stream of its vector and its global index,
+// so vectors generated by root and by every process for its block are identical
+static constexpr std::uint64_t SEED = 0x5eed;
+static constexpr std::uint32_t A_STREAM = 0;
+static constexpr std::uint32_t B_STREAM = 1;
+static constexpr double MAX_VALUE = 1000;
+
+// Elements of every vector, unless the size is passed as --size CLI-argument
+static constexpr std::size_t DEFAULT_SIZE = 1 << 23;
+
+// Chunk sizes (elements per process and round) of the pipelined dot product, unless
+// one is passed as --chunk-size CLI-argument
+static constexpr std::size_t PIPELINE_CHUNK_SIZES[] = { 1 << 12, 1 << 14, 1 << 16, 1 << 18, 1 << 20 };
+
+my::random::UniformRealSequence make_sequence(std::uint32_t stream)
+{
+    return my::random::UniformRealSequence(SEED, stream, -MAX_VALUE, MAX_VALUE);
+}
+
 struct Data
 {
     bc::vector<double> a;
@@ -31,19 +61,30 @@ Data generate_data(std::size_t size)
         data.a.resize(size, bc::default_init_t{});
         data.b.resize(size, bc::default_init_t{});
 
-        auto generator = []()
+        my::random::UniformRealSequence a_sequence = make_sequence(A_STREAM);
+        my::random::UniformRealSequence b_sequence = make_sequence(B_STREAM);
+        for (std::size_t i = 0; i < size; ++i)
         {
-            static std::mt19937 prng(std::random_device{}());
-            static std::uniform_real_distribution<double> dist(-1000, 1000);
-            return dist(prng);
-        };
-
-        std::generate(data.a.data(), data.a.data() + size, generator);
-        std::generate(data.b.data(), data.b.data() + size, generator);
+            data.a[i] = a_sequence(i);
+            data.b[i] = b_sequence(i);
+        }
     }
     return data;
 }
 
+struct DistributedData
+{
+    my::distributed::DistributedVector a;
+    my::distributed::DistributedVector b;
+};
+
+// Every process generates its own blocks, neither root nor communication is involved
+DistributedData generate_distributed_data(std::size_t size)
+{
+    return { .a = my::distributed::DistributedVector::generate(size, make_sequence(A_STREAM)),
+             .b = my::distributed::DistributedVector::generate(size, make_sequence(B_STREAM)) };
+}
+
 double dot_product_regular(const double* a, const double* b, std::size_t size)
 {
     double dot_product = 0;
@@ -54,100 +95,217 @@ double dot_product_regular(const double* a, const double* b, std::size_t size)
     return dot_product;
 }
 
+// Scatters both vectors on every call, as a single dot product of vectors held by root would
 double dot_product_mpi(const double* a, const double* b, std::size_t size)
+{
+    my::distributed::DistributedVector a_part = my::distributed::DistributedVector::scatter(a, size);
+    my::distributed::DistributedVector b_part = my::distributed::DistributedVector::scatter(b, size);
+    return my::distributed::dot_product(a_part, b_part);
+}
+
+// Variants that read vectors held by root are measured only if root_data is set, vectors of the
+// others are generated by every process for its block and may be larger than memory of root
+void benchmark(const double* a, const double* b, std::size_t size, bool root_data, const std::vector<std::size_t>& chunk_sizes, my::ResultSink& sink)
 {
     const auto& mpi_params = my::mpi::Params::get_instance();
 
-    auto get_offset = [&mpi_params](std::size_t index, std::size_t size) -> std::size_t
+    if (root_data && my::mpi::is_current_process_root())
     {
-        std::size_t offset;
-        std::size_t quotient = size / mpi_params.process_count();
-        std::size_t remainder = size % mpi_params.process_count();
-
-        if (index <= remainder)
+        auto generate_data_wrapper = [size]()
         {
-            offset = (quotient + 1) * index;
-        }
-        else
-        {
-            offset = (quotient + 1) * remainder;
-            offset += quotient * (index - remainder);
-        }
+            return generate_data(size).a.size();
+        };
+        sink.write({ .name = "Root generation",
+                     .params = { { "size", static_cast<std::int64_t>(size) },
+                                 { "processes", std::int64_t{ 1 } },
+                                 { "threads", std::int64_t{ 1 } },
+                                 { "precision", "double" } },
+                     .result = my::run_benchmark(generate_data_wrapper, BENCHMARK_PARAMS) });
+    }
 
-        return offset;
-    };
+    my::BenchmarkResult local_generation_result;
+    {
+        auto generate_distributed_data_wrapper = [size]()
+        {
+            return generate_distributed_data(size).a.local_size();
+        };
+        local_generation_result = my::run_benchmark(generate_distributed_data_wrapper, BENCHMARK_PARAMS);
+    }
+    if (my::mpi::is_current_process_root())
+    {
+        sink.write({ .name = "Local generation",
+                     .params = { { "size", static_cast<std::int64_t>(size) },
+                                 { "processes", static_cast<std::int64_t>(mpi_params.process_count()) },
+                                 { "threads", static_cast<std::int64_t>(omp_get_max_threads()) },
+                                 { "precision", "double" } },
+                     .result = local_generation_result });
+    }
 
-    auto get_count = [&mpi_params](std::size_t index, std::size_t size) -> std::size_t
+    if (root_data && my::mpi::is_current_process_root())
     {
-        std::size_t count;
-        std::size_t quotient  = size / mpi_params.process_count();
-        std::size_t remainder = size % mpi_params.process_count();
+        auto dot_product_regular_wrapper = [a, b, size]()
+        {
+            return dot_product_regular(a, b, size);
+        };
+        my::BenchmarkResult dot_product_regular_result = my::run_benchmark(dot_product_regular_wrapper, BENCHMARK_PARAMS);
+        sink.write({ .name = "Regular time",
+                     .params = { { "size", static_cast<std::int64_t>(size) },
+                                 { "processes", std::int64_t{ 1 } },
+                                 { "threads", std::int64_t{ 1 } },
+                                 { "precision", "double" } },
+                     .result = dot_product_regular_result });
+    }
 
-        count = quotient + (index < remainder ? 1 : 0);
+    if (root_data)
+    {
+        my::BenchmarkResult dot_product_mpi_result;
+        {
+            auto dot_product_mpi_wrapper = [a, b, size]()
+            {
+                return dot_product_mpi(a, b, size);
+            };
+            dot_product_mpi_result = my::run_benchmark(dot_product_mpi_wrapper, BENCHMARK_PARAMS);
+        }
+        if (my::mpi::is_current_process_root())
+        {
+            sink.write({ .name = "MPI time",
+                         .params = { { "size", static_cast<std::int64_t>(size) },
+                                     { "processes", static_cast<std::int64_t>(mpi_params.process_count()) },
+                                     { "threads", static_cast<std::int64_t>(omp_get_max_threads()) },
+                                     { "precision", "double" } },
+                         .result = dot_product_mpi_result });
+        }
 
-        return count;
-    };
+        // Scatter of chunk k + 1 overlaps the local loop over chunk k
+        for (std::size_t chunk_size : chunk_sizes)
+        {
+            auto dot_product_pipelined_wrapper = [a, b, size, chunk_size]()
+            {
+                return my::distributed::dot_product_pipelined(a, b, size, chunk_size);
+            };
+            my::BenchmarkResult dot_product_pipelined_result = my::run_benchmark(dot_product_pipelined_wrapper, BENCHMARK_PARAMS);
+            if (my::mpi::is_current_process_root())
+            {
+                sink.write({ .name = "Pipelined time",
+                             .params = { { "size", static_cast<std::int64_t>(size) },
+                                         { "processes", static_cast<std::int64_t>(mpi_params.process_count()) },
+                                         { "threads", static_cast<std::int64_t>(omp_get_max_threads()) },
+                                         { "chunk_size", static_cast<std::int64_t>(chunk_size) },
+                                         { "precision", "double" } },
+                             .result = dot_product_pipelined_result,
+                             .metrics = { { "chunk_size", static_cast<double>(chunk_size) },
+                                          { "rounds", static_cast<double>(my::distributed::pipeline_rounds_count(size, chunk_size)) } } });
+            }
+        }
 
-    bc::vector<int> counts, offsets;
+        // Cost of distributing both vectors once
+        my::BenchmarkResult scatter_result;
+        {
+            auto scatter_wrapper = [a, b, size]()
+            {
+                my::distributed::DistributedVector a_part = my::distributed::DistributedVector::scatter(a, size);
+                my::distributed::DistributedVector b_part = my::distributed::DistributedVector::scatter(b, size);
+                return a_part.local_size() + b_part.local_size();
+            };
+            scatter_result = my::run_benchmark(scatter_wrapper, BENCHMARK_PARAMS);
+        }
+        if (my::mpi::is_current_process_root())
+        {
+            sink.write({ .name = "Scatter time",
+                         .params = { { "size", static_cast<std::int64_t>(size) },
+                                     { "processes", static_cast<std::int64_t>(mpi_params.process_count()) },
+                                     { "threads", static_cast<std::int64_t>(omp_get_max_threads()) },
+                                     { "precision", "double" } },
+                         .result = scatter_result });
+        }
+    }
 
+    // Steady state: vectors are already distributed, only the local kernel and MPI_Allreduce remain
+    DistributedData distributed_data = generate_distributed_data(size);
+    my::BenchmarkResult distributed_result;
+    {
+        auto distributed_wrapper = [&distributed_data]()
+        {
+            return my::distributed::dot_product(distributed_data.a, distributed_data.b);
+        };
+        distributed_result = my::run_benchmark(distributed_wrapper, BENCHMARK_PARAMS);
+    }
     if (my::mpi::is_current_process_root())
     {
-        counts.resize (mpi_params.process_count(), bc::default_init_t{});
-        offsets.resize(mpi_params.process_count(), bc::default_init_t{});
+        sink.write({ .name = "Distributed time",
+                     .params = { { "size", static_cast<std::int64_t>(size) },
+                                 { "processes", static_cast<std::int64_t>(mpi_params.process_count()) },
+                                 { "threads", static_cast<std::int64_t>(omp_get_max_threads()) },
+                                 { "precision", "double" } },
+                     .result = distributed_result });
+    }
 
-        for (std::size_t i = 0; i < mpi_params.process_count(); ++i)
+    // Same as above, but the result does not depend on the number of processes
+    my::BenchmarkResult reproducible_result;
+    {
+        auto reproducible_wrapper = [&distributed_data]()
         {
-            offsets[i] = static_cast<int>(get_offset(i, size));
-            counts[i]  = static_cast<int>(get_count(i, size));
-        }
+            return my::distributed::dot_product_reproducible(distributed_data.a, distributed_data.b);
+        };
+        reproducible_result = my::run_benchmark(reproducible_wrapper, BENCHMARK_PARAMS);
     }
-
-    std::size_t size_part = get_count(mpi_params.process_id(), size);
-    bc::vector<double> a_part(size_part, bc::default_init_t{});
-    bc::vector<double> b_part(size_part, bc::default_init_t{});
-
-    my::mpi::scatterv(a, counts.data(), offsets.data(), MPI_DOUBLE, a_part.data(), static_cast<int>(size_part), MPI_DOUBLE);
-    my::mpi::scatterv(b, counts.data(), offsets.data(), MPI_DOUBLE, b_part.data(), static_cast<int>(size_part), MPI_DOUBLE);
-
-    double dot_product_part = 0;
-    for (std::size_t i = 0; i < size_part; ++i)
+    if (my::mpi::is_current_process_root())
     {
-        dot_product_part += a_part[i] * b_part[i];
+        sink.write({ .name = "Reproducible time",
+                     .params = { { "size", static_cast<std::int64_t>(size) },
+                                 { "processes", static_cast<std::int64_t>(mpi_params.process_count()) },
+                                 { "threads", static_cast<std::int64_t>(omp_get_max_threads()) },
+                                 { "precision", "double" } },
+                     .result = reproducible_result });
     }
 
-    double dot_product = 0;
-    my::mpi::reduce(&dot_product_part, &dot_product, 1, MPI_DOUBLE, MPI_SUM);
-
-    return dot_product;
-}
-
-void benchmark(const double* a, const double* b, std::size_t size)
-{
-    if (my::mpi::is_current_process_root())
+    // Vectors are scattered to one process per node and shared by processes of a node
+    my::distributed::NodeCommunicators node_communicators;
+    if (root_data)
     {
-        auto dot_product_regular_wrapper = [a, b, size]()
+        my::BenchmarkResult shared_scatter_result;
         {
-            return dot_product_regular(a, b, size);
-        };
-        double dot_product_regular_result = my::benchmark_function(dot_product_regular_wrapper, ITERATIONS_COUNT);
-        my::print_result("Regular time: ", dot_product_regular_result);
+            auto shared_scatter_wrapper = [&node_communicators, a, b, size]()
+            {
+                my::distributed::NodeSharedVector a_part = my::distributed::NodeSharedVector::scatter(node_communicators, a, size);
+                my::distributed::NodeSharedVector b_part = my::distributed::NodeSharedVector::scatter(node_communicators, b, size);
+                return a_part.local_size() + b_part.local_size();
+            };
+            shared_scatter_result = my::run_benchmark(shared_scatter_wrapper, BENCHMARK_PARAMS);
+        }
+        if (my::mpi::is_current_process_root())
+        {
+            sink.write({ .name = "Shared scatter time",
+                         .params = { { "size", static_cast<std::int64_t>(size) },
+                                     { "processes", static_cast<std::int64_t>(mpi_params.process_count()) },
+                                     { "threads", static_cast<std::int64_t>(omp_get_max_threads()) },
+                                     { "precision", "double" } },
+                         .result = shared_scatter_result });
+        }
     }
 
-    double dot_product_mpi_result;
+    my::BenchmarkResult shared_result;
     {
-        auto dot_product_mpi_wrapper = [a, b, size]()
+        my::distributed::NodeSharedVector a_part = my::distributed::NodeSharedVector::generate(node_communicators, size, make_sequence(A_STREAM));
+        my::distributed::NodeSharedVector b_part = my::distributed::NodeSharedVector::generate(node_communicators, size, make_sequence(B_STREAM));
+        auto shared_wrapper = [&a_part, &b_part]()
         {
-            return dot_product_mpi(a, b, size);
+            return my::distributed::dot_product(a_part, b_part);
         };
-        dot_product_mpi_result = my::benchmark_function(dot_product_mpi_wrapper, ITERATIONS_COUNT);
+        shared_result = my::run_benchmark(shared_wrapper, BENCHMARK_PARAMS);
     }
     if (my::mpi::is_current_process_root())
     {
-        my::print_result("    MPI time: ", dot_product_mpi_result);
+        sink.write({ .name = "Shared time",
+                     .params = { { "size", static_cast<std::int64_t>(size) },
+                                 { "processes", static_cast<std::int64_t>(mpi_params.process_count()) },
+                                 { "threads", static_cast<std::int64_t>(omp_get_max_threads()) },
+                                 { "precision", "double" } },
+                     .result = shared_result });
     }
 }
 
-void test(const double* a, const double* b, std::size_t size)
+void test(const double* a, const double* b, std::size_t size, const std::vector<std::size_t>& chunk_sizes)
 {
     auto are_doubles_equal = [](double a, double b) -> bool
     {
@@ -156,6 +314,24 @@ void test(const double* a, const double* b, std::size_t size)
     };
 
     double result_mpi = dot_product_mpi(a, b, size);
+    std::vector<double> results_pipelined;
+    for (std::size_t chunk_size : chunk_sizes)
+    {
+        results_pipelined.push_back(my::distributed::dot_product_pipelined(a, b, size, chunk_size));
+    }
+
+    // Blocks generated by processes must be the same as the vectors generated by root, so
+    // reproducible dot products must be bit-identical
+    DistributedData distributed_data = generate_distributed_data(size);
+    double result_reproducible_mpi = my::distributed::dot_product_reproducible(distributed_data.a, distributed_data.b);
+
+    double result_shared;
+    {
+        my::distributed::NodeCommunicators node_communicators;
+        my::distributed::NodeSharedVector a_part = my::distributed::NodeSharedVector::scatter(node_communicators, a, size);
+        my::distributed::NodeSharedVector b_part = my::distributed::NodeSharedVector::scatter(node_communicators, b, size);
+        result_shared = my::distributed::dot_product(a_part, b_part);
+    }
 
     if (my::mpi::is_current_process_root())
     {
@@ -164,32 +340,174 @@ void test(const double* a, const double* b, std::size_t size)
         {
             throw std::runtime_error("Test failed!");
         }
+        for (double result_pipelined : results_pipelined)
+        {
+            if (!are_doubles_equal(result_regular, result_pipelined))
+            {
+                throw std::runtime_error("Test failed: pipelined dot product differs from the regular one");
+            }
+        }
+        if (!are_doubles_equal(result_regular, result_shared))
+        {
+            throw std::runtime_error("Test failed: dot product of node shared vectors differs from the regular one");
+        }
+        double result_reproducible = my::distributed::dot_product_reproducible(a, b, size);
+        if (result_reproducible != result_reproducible_mpi)
+        {
+            throw std::runtime_error("Test failed: distributed reproducible dot product differs from the serial one");
+        }
         std::cout << "Test passed" << std::endl;
     }
 }
 
+// Positive integer CLI-argument --name=<value>
+int positive_int_option(int argc, char* argv[], std::string_view name, int default_value)
+{
+    std::optional<std::string_view> value = my::find_cmd_line_option(argc, argv, name);
+    if (!value)
+    {
+        return default_value;
+    }
+    std::string s(*value);
+    try
+    {
+        std::size_t pos;
+        int result = std::stoi(s, &pos);
+        if (pos != s.size() || result < 1)
+        {
+            throw std::invalid_argument("expected a positive integer");
+        }
+        return result;
+    }
+    catch (const std::exception& e)
+    {
+        throw std::invalid_argument("Error: cannot convert --" + std::string(name) + "=\"" + s + "\" to a positive int: \"" + e.what() + "\"");
+    }
+}
+
+// Positive 64-bit CLI-argument --name=<value>, e.g. a number of elements
+std::size_t positive_size_option(int argc, char* argv[], std::string_view name, std::size_t default_value)
+{
+    std::optional<std::string_view> value = my::find_cmd_line_option(argc, argv, name);
+    if (!value)
+    {
+        return default_value;
+    }
+    std::string s(*value);
+    try
+    {
+        std::size_t pos;
+        unsigned long long result = std::stoull(s, &pos);
+        if (pos != s.size() || result < 1 || s.front() == '-')
+        {
+            throw std::invalid_argument("expected a positive integer");
+        }
+        return static_cast<std::size_t>(result);
+    }
+    catch (const std::exception& e)
+    {
+        throw std::invalid_argument("Error: cannot convert --" + std::string(name) + "=\"" + s + "\" to a positive size: \"" + e.what() + "\"");
+    }
+}
+
+// CLI-argument --name=yes|no
+bool bool_option(int argc, char* argv[], std::string_view name, bool default_value)
+{
+    std::optional<std::string_view> value = my::find_cmd_line_option(argc, argv, name);
+    if (!value)
+    {
+        return default_value;
+    }
+    if (*value == "yes")
+        return true;
+    if (*value == "no")
+        return false;
+
+    throw std::invalid_argument("Error: --" + std::string(name) + " must be \"yes\" or \"no\", got \"" + std::string(*value) + "\"");
+}
+
+// Pins every OpenMP thread of the process according to the rank of the process on the node and
+// the thread number, threads of a process get consecutive slots. Prints placement of all processes.
+void pin_process(my::OutputFormat format, const my::topology::Pinning& pinning, my::mpi::Threading threading)
+{
+    const auto& mpi_params = my::mpi::Params::get_instance();
+    int thread_count = omp_get_max_threads();
+    my::topology::Topology topology = my::topology::Topology::detect();
+    std::vector<int> placement = my::topology::make_placement(topology, pinning, mpi_params.local_process_count() * thread_count);
+    if (!placement.empty())
+    {
+        std::exception_ptr exception;
+        #pragma omp parallel num_threads(thread_count)
+        {
+            try
+            {
+                my::topology::pin_current_thread(placement[mpi_params.local_process_id() * thread_count + omp_get_thread_num()]);
+            }
+            catch (...)
+            {
+                #pragma omp critical
+                exception = std::current_exception();
+            }
+        }
+        if (exception)
+        {
+            std::rethrow_exception(exception);
+        }
+    }
+
+    std::ostream& header = my::header_stream(format);
+    if (my::mpi::is_current_process_root())
+    {
+        header << "Topology: " << topology.describe() << std::endl
+               << "Pinning: " << my::topology::to_string(pinning.policy) << std::endl
+               << "Threads per process: " << thread_count << ", MPI thread support: " << my::mpi::to_string(threading) << std::endl;
+    }
+    my::mpi::report_placement(header, my::topology::current_cpu());
+}
+
 }  // namespace
 
 int main(int argc, char* argv[]) try
 {
-    my::mpi::Control mpi_control(argc, argv);
+    // MPI is called only by the master thread outside of parallel regions, so funneled is enough
+    my::mpi::Control mpi_control(argc, argv, my::mpi::threading_from_string(my::find_cmd_line_option(argc, argv, "mpi-threading").value_or("funneled")));
+
+    // Threads of every process for the local part of distributed operations, one by default
+    // to keep the pure MPI layout with a process per CPU
+    omp_set_num_threads(positive_int_option(argc, argv, "threads", 1));
+    // Thread teams must consist of the threads pinned below
+    omp_set_dynamic(0);
+
+    my::OutputFormat format = my::output_format_from_cmd_line(argc, argv);
+    pin_process(format, my::topology::pinning_from_string(my::find_cmd_line_option(argc, argv, "pin").value_or("none")),
+                mpi_control.provided_threading());
+
+    std::unique_ptr<my::ResultSink> sink = my::make_result_sink(format, "mpi-dot-product", 19);
 
     const auto& mpi_params = my::mpi::Params::get_instance();
-    static constexpr int size = 1 << 23;
+    std::size_t size = positive_size_option(argc, argv, "size", DEFAULT_SIZE);
 
     if (size < mpi_params.process_count())
     {
         throw std::runtime_error("Vector length is less than processor count, please decrease number of processors.");
     }
 
-    auto [a, b] = generate_data(size);
+    std::vector<std::size_t> chunk_sizes(std::begin(PIPELINE_CHUNK_SIZES), std::end(PIPELINE_CHUNK_SIZES));
+    if (my::find_cmd_line_option(argc, argv, "chunk-size"))
+    {
+        chunk_sizes = { positive_size_option(argc, argv, "chunk-size", 1) };
+    }
 
     bool do_test = false;
 
+    // Both vectors on root take 16 bytes per element, --root-data=no skips them
+    bool root_data = do_test || bool_option(argc, argv, "root-data", true);
+    auto [a, b] = root_data ? generate_data(size) : Data();
+
     if (do_test)
-        test(a.data(), b.data(), size);
+        test(a.data(), b.data(), size, chunk_sizes);
     else
-        benchmark(a.data(), b.data(), size);
+        benchmark(a.data(), b.data(), size, root_data, chunk_sizes, *sink);
 
     return EXIT_SUCCESS;
 }
@@ -0,0 +1,89 @@
+#include <node_shared_vector.hpp>
+
+#include <boost/container/vector.hpp>
+
+#include <stdexcept>
+
+namespace my::distributed
+{
+
+namespace bc = boost::container;
+
+NodeSharedVector::NodeSharedVector(const NodeCommunicators& communicators, std::size_t size)
+    : m_size(size)
+{
+    // Only node leaders know the number of nodes and the index of their node
+    int node_index_and_count[2] = { 0, 0 };
+    if (!communicators.leaders.is_null())
+    {
+        node_index_and_count[0] = communicators.leaders.rank();
+        node_index_and_count[1] = communicators.leaders.size();
+    }
+    communicators.node.bcast(my::mpi::Span(node_index_and_count), 0);
+
+    Partition node_partition(size, static_cast<std::size_t>(node_index_and_count[1]), REPRODUCIBLE_CHUNK_SIZE);
+    m_node_offset = node_partition.offset(static_cast<std::size_t>(node_index_and_count[0]));
+    m_node_size = node_partition.count(static_cast<std::size_t>(node_index_and_count[0]));
+
+    Partition local_partition(m_node_size, static_cast<std::size_t>(communicators.node.size()), REPRODUCIBLE_CHUNK_SIZE);
+    int local_id = communicators.node.rank();
+    m_offset = m_node_offset + local_partition.offset(static_cast<std::size_t>(local_id));
+    m_local_size = local_partition.count(static_cast<std::size_t>(local_id));
+
+    // The whole block of the node is allocated by its leader
+    m_window = std::make_unique<my::mpi::SharedWindow>(communicators.node, local_id == 0 ? m_node_size * sizeof(double) : 0);
+    m_node_data = static_cast<double*>(m_window->data(0));
+}
+
+NodeSharedVector NodeSharedVector::scatter(const NodeCommunicators& communicators, const double* data, std::size_t size)
+{
+    NodeSharedVector vector(communicators, size);
+
+    if (!communicators.leaders.is_null())
+    {
+        int nodes_count = communicators.leaders.size();
+        Partition node_partition(size, static_cast<std::size_t>(nodes_count), REPRODUCIBLE_CHUNK_SIZE);
+
+        bc::vector<my::mpi::Count> counts;
+        bc::vector<my::mpi::Displacement> offsets;
+        if (my::mpi::is_current_process_root())
+        {
+            counts.resize (nodes_count, bc::default_init_t{});
+            offsets.resize(nodes_count, bc::default_init_t{});
+
+            for (int i = 0; i < nodes_count; ++i)
+            {
+                offsets[i] = static_cast<my::mpi::Displacement>(node_partition.offset(static_cast<std::size_t>(i)));
+                counts[i]  = static_cast<my::mpi::Count>(node_partition.count(static_cast<std::size_t>(i)));
+            }
+        }
+
+        // Root of COMM has rank 0 in its node and among node leaders
+        communicators.leaders.scatterv(my::mpi::Span(data, size), counts, offsets, my::mpi::Span(vector.m_node_data, vector.m_node_size), 0);
+    }
+
+    vector.m_window->synchronize();
+    return vector;
+}
+
+double dot_product(const NodeSharedVector& a, const NodeSharedVector& b)
+{
+    if (a.size() != b.size())
+    {
+        throw std::invalid_argument("Node shared vectors have different sizes");
+    }
+
+    const double* a_part = a.local_data();
+    const double* b_part = b.local_data();
+    std::size_t size_part = a.local_size();
+    double dot_product_part = 0;
+    #pragma omp parallel for simd schedule(static) reduction(+ : dot_product_part)
+    for (std::size_t i = 0; i < size_part; ++i)
+    {
+        dot_product_part += a_part[i] * b_part[i];
+    }
+
+    return my::mpi::Communicator::world().allreduce(dot_product_part, MPI_SUM);
+}
+
+}  // namespace my::distributed
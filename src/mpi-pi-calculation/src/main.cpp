@@ -1,5 +1,6 @@
 #include <benchmark.hpp>
 #include <mpi.hpp>
+#include <topology.hpp>
 #include <pi_helpers.hpp>
 
 #include <gmpxx.h>
@@ -9,8 +10,10 @@
 #include <cmath>
 #include <iostream>
 #include <functional>
+#include <memory>
 #include <stdexcept>
 #include <unordered_map>
+#include <vector>
 
 namespace
 {
@@ -108,9 +111,10 @@ template <typename RegularPiCalculationFunction,
 void benchmark(std::size_t summand_count,
                mp_bitcnt_t precision,
                RegularPiCalculationFunction pi_regular,
-               MPIPiCalculationFunction pi_mpi)
+               MPIPiCalculationFunction pi_mpi,
+               my::ResultSink& sink)
 {
-    static constexpr std::size_t ITERATIONS_COUNT = 100;
+    static constexpr my::BenchmarkParams BENCHMARK_PARAMS = { .warmup_count = 2, .samples_count = 100 };
     const auto& mpi_params = my::mpi::Params::get_instance();
 
     if (summand_count < mpi_params.process_count())
@@ -124,21 +128,29 @@ void benchmark(std::size_t summand_count,
         {
             return pi_regular(summand_count, precision);
         };
-        double pi_regular_result = my::benchmark_function(pi_regular_wrapper, ITERATIONS_COUNT);
-        my::print_result("Regular time: ", pi_regular_result);
+        my::BenchmarkResult pi_regular_result = my::run_benchmark(pi_regular_wrapper, BENCHMARK_PARAMS);
+        sink.write({ .name = "Regular time",
+                     .params = { { "summands", static_cast<std::int64_t>(summand_count) },
+                                 { "precision", static_cast<std::int64_t>(precision) },
+                                 { "processes", std::int64_t{ 1 } } },
+                     .result = pi_regular_result });
     }
 
-    double pi_mpi_result;
+    my::BenchmarkResult pi_mpi_result;
     {
         auto pi_mpi_wrapper = [summand_count, precision, pi_mpi]()
         {
             return pi_mpi(summand_count, precision);
         };
-        pi_mpi_result = my::benchmark_function(pi_mpi_wrapper, ITERATIONS_COUNT);
+        pi_mpi_result = my::run_benchmark(pi_mpi_wrapper, BENCHMARK_PARAMS);
     }
     if (my::mpi::is_current_process_root())
     {
-        my::print_result("    MPI time: ", pi_mpi_result);
+        sink.write({ .name = "MPI time",
+                     .params = { { "summands", static_cast<std::int64_t>(summand_count) },
+                                 { "precision", static_cast<std::int64_t>(precision) },
+                                 { "processes", static_cast<std::int64_t>(mpi_params.process_count()) } },
+                     .result = pi_mpi_result });
     }
 }
 
@@ -167,12 +179,37 @@ void calculate(std::size_t summand_count,
     }
 }
 
+// Pins the process according to its rank on the node and prints placement of all processes
+void pin_process(my::OutputFormat format, const my::topology::Pinning& pinning)
+{
+    const auto& mpi_params = my::mpi::Params::get_instance();
+    my::topology::Topology topology = my::topology::Topology::detect();
+    std::vector<int> placement = my::topology::make_placement(topology, pinning, mpi_params.local_process_count());
+    if (!placement.empty())
+    {
+        my::topology::pin_current_thread(placement[mpi_params.local_process_id()]);
+    }
+
+    std::ostream& header = my::header_stream(format);
+    if (my::mpi::is_current_process_root())
+    {
+        header << "Topology: " << topology.describe() << std::endl
+               << "Pinning: " << my::topology::to_string(pinning.policy) << std::endl;
+    }
+    my::mpi::report_placement(header, my::topology::current_cpu());
+}
+
 }  // namespace
 
 int main(int argc, char* argv[]) try
 {
     my::mpi::Control mpi_control(argc, argv);
 
+    my::OutputFormat format = my::output_format_from_cmd_line(argc, argv);
+    pin_process(format, my::topology::pinning_from_string(my::find_cmd_line_option(argc, argv, "pin").value_or("none")));
+
+    std::unique_ptr<my::ResultSink> sink = my::make_result_sink(format, "mpi-pi-calculation", 12);
+
     struct AlgorithmInfo
     {
         const std::function<mpf_class(std::size_t summand_count, mp_bitcnt_t precision)> pi_regular;
@@ -221,7 +258,8 @@ int main(int argc, char* argv[]) try
         benchmark(algorithm_info.params.benchmark_summand_count,
                   algorithm_info.params.precision,
                   algorithm_info.pi_regular,
-                  algorithm_info.pi_mpi);
+                  algorithm_info.pi_mpi,
+                  *sink);
     }
     else
     {
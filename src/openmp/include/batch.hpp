@@ -0,0 +1,133 @@
+#ifndef PARALLEL_COMPUTING_OPENMP_BATCH_HPP_
+#define PARALLEL_COMPUTING_OPENMP_BATCH_HPP_
+
+#include <simd_math.hpp>
+
+#include <omp.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+// Many integrals of one parametrized function at once. Kernels take a point and a parameter
+// (e.g. [](auto x, auto p) { return my::simd_math::pow(x, p); }) and are evaluated for
+// a vector of different jobs at a time instead of a vector of points of one job.
+
+namespace my::batch
+{
+
+// Structure of arrays of jobs: integral of kernel(x, parameters[i]) over [from[i], to[i]]
+struct Jobs
+{
+    std::vector<double> from;
+    std::vector<double> to;
+    std::vector<double> parameters;
+
+    std::size_t size() const
+    {
+        return from.size();
+    }
+};
+
+// Left rectangle sum of a job in points from, from + dx, ..., to, the same as for a Domain
+inline std::int64_t points_count(double from, double to, double dx)
+{
+    return static_cast<std::int64_t>((to - from) / dx) + 1;
+}
+
+namespace detail
+{
+
+inline void check_jobs(const Jobs& jobs)
+{
+    if (jobs.to.size() != jobs.size() || jobs.parameters.size() != jobs.size())
+    {
+        throw std::invalid_argument("Jobs must have the same number of bounds and parameters");
+    }
+}
+
+}  // namespace detail
+
+// Integrates all jobs with step dx and writes integrals to results[i]. Jobs are sorted by their
+// number of points, so that lanes of a vector finish together, and vectors of jobs are
+// distributed dynamically from the longest ones, which balances the load across threads.
+template <typename Isa = simd_math::NativeIsa, typename Kernel>
+void integrate_simd_parallel(Kernel kernel, const Jobs& jobs, double dx, double* results, int thread_count)
+{
+    using vector_t = typename Isa::vector_t;
+    static constexpr std::int64_t LANES = Isa::LANES;
+
+    detail::check_jobs(jobs);
+    std::int64_t jobs_count = static_cast<std::int64_t>(jobs.size());
+    std::vector<std::int64_t> counts(jobs_count);
+    for (std::int64_t i = 0; i < jobs_count; ++i)
+    {
+        counts[i] = points_count(jobs.from[i], jobs.to[i], dx);
+    }
+    std::vector<std::int64_t> order(jobs_count);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&counts](std::int64_t a, std::int64_t b) { return counts[a] > counts[b]; });
+
+    std::int64_t groups_count = (jobs_count + LANES - 1) / LANES;
+    omp_set_num_threads(thread_count);
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (std::int64_t group = 0; group < groups_count; ++group)
+    {
+        // Missing lanes of the last group get empty jobs
+        double from[LANES];
+        double parameters[LANES];
+        double lane_counts[LANES];
+        for (std::int64_t lane = 0; lane < LANES; ++lane)
+        {
+            std::int64_t index = group * LANES + lane;
+            bool exists = index < jobs_count;
+            from[lane] = exists ? jobs.from[order[index]] : 0;
+            parameters[lane] = exists ? jobs.parameters[order[index]] : 1;
+            lane_counts[lane] = exists ? static_cast<double>(counts[order[index]]) : 0;
+        }
+
+        vector_t from_vector = Isa::load(from);
+        vector_t parameters_vector = Isa::load(parameters);
+        vector_t counts_vector = Isa::load(lane_counts);
+        vector_t zero = Isa::set1(0);
+        vector_t sum = zero;
+        // The first lane has the longest job of the group
+        std::int64_t max_count = static_cast<std::int64_t>(lane_counts[0]);
+        for (std::int64_t i = 0; i < max_count; ++i)
+        {
+            vector_t index = Isa::set1(static_cast<double>(i));
+            vector_t value = kernel(Isa::add(from_vector, Isa::mul(index, Isa::set1(dx))), parameters_vector);
+            sum = Isa::add(sum, Isa::select(Isa::less(index, counts_vector), value, zero));
+        }
+
+        double sums[LANES];
+        Isa::store(sums, sum);
+        for (std::int64_t lane = 0; lane < LANES && group * LANES + lane < jobs_count; ++lane)
+        {
+            results[order[group * LANES + lane]] = dx * sums[lane];
+        }
+    }
+}
+
+// Baseline: every job is vectorized over its own points, jobs are distributed dynamically.
+// The kernel is called with a vector of points and a scalar parameter.
+template <typename Isa = simd_math::NativeIsa, typename Kernel>
+void integrate_per_job_parallel(Kernel kernel, const Jobs& jobs, double dx, double* results, int thread_count)
+{
+    detail::check_jobs(jobs);
+    std::int64_t jobs_count = static_cast<std::int64_t>(jobs.size());
+    omp_set_num_threads(thread_count);
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (std::int64_t i = 0; i < jobs_count; ++i)
+    {
+        double parameter = jobs.parameters[i];
+        auto job_kernel = [&kernel, parameter](auto x) { return kernel(x, parameter); };
+        results[i] = dx * simd_math::sum_points<Isa>(job_kernel, jobs.from[i], dx, 0, points_count(jobs.from[i], jobs.to[i], dx));
+    }
+}
+
+}  // namespace my::batch
+
+#endif  // PARALLEL_COMPUTING_OPENMP_BATCH_HPP_
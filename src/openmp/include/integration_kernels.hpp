@@ -0,0 +1,38 @@
+#ifndef PARALLEL_COMPUTING_OPENMP_INTEGRATION_KERNELS_HPP_
+#define PARALLEL_COMPUTING_OPENMP_INTEGRATION_KERNELS_HPP_
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// Hand-written left rectangle sums of a values table for every x86-64 vector width.
+// Kernels are compiled with function-level target attributes and selected at run time,
+// so the sample can be built for baseline x86-64 and still use AVX2 or AVX-512.
+
+namespace my::kernels
+{
+
+enum class Isa
+{
+    SSE2,
+    AVX2,
+    AVX512,
+};
+
+std::string_view to_string(Isa isa);
+
+// Instruction sets supported by both the CPU and the OS, from the narrowest to the widest
+const std::vector<Isa>& supported_isas();
+
+// Computes dx * (values[0] + ... + values[count - 1])
+using integrate_kernel_t = double (*)(const double* values, std::int64_t count, double dx);
+
+// Throws std::invalid_argument if the instruction set is not supported
+integrate_kernel_t integrate_kernel(Isa isa);
+
+// Kernel of the widest supported instruction set
+integrate_kernel_t best_integrate_kernel();
+
+}  // namespace my::kernels
+
+#endif  // PARALLEL_COMPUTING_OPENMP_INTEGRATION_KERNELS_HPP_
@@ -0,0 +1,32 @@
+#ifndef PARALLEL_COMPUTING_OPENMP_PARALLEL_BACKENDS_HPP_
+#define PARALLEL_COMPUTING_OPENMP_PARALLEL_BACKENDS_HPP_
+
+#include <cstdint>
+
+// The same reductions on runtimes other than OpenMP: C++17 parallel algorithms
+// (std::transform_reduce with std::execution::par_unseq) and oneTBB parallel_reduce.
+// Both are built only if oneTBB is found (PC_HAS_TBB), since libstdc++ runs parallel
+// algorithms on top of it. Thread count is limited with a tbb::task_arena.
+
+namespace my::backends
+{
+
+#if defined(PC_HAS_TBB)
+inline constexpr bool TBB_AVAILABLE = true;
+#else
+inline constexpr bool TBB_AVAILABLE = false;
+#endif
+
+// dx * (values[0] + ... + values[count - 1])
+double integrate_std_parallel(const double* values, std::int64_t count, double dx, int thread_count);
+double integrate_tbb_parallel(const double* values, std::int64_t count, double dx, int thread_count);
+
+// a[0] * b[0] + ... + a[size - 1] * b[size - 1]
+double dot_product_regular(const double* a, const double* b, std::int64_t size);
+double dot_product_omp_parallel(const double* a, const double* b, std::int64_t size, int thread_count);
+double dot_product_std_parallel(const double* a, const double* b, std::int64_t size, int thread_count);
+double dot_product_tbb_parallel(const double* a, const double* b, std::int64_t size, int thread_count);
+
+}  // namespace my::backends
+
+#endif  // PARALLEL_COMPUTING_OPENMP_PARALLEL_BACKENDS_HPP_
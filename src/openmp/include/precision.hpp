@@ -0,0 +1,194 @@
+#ifndef PARALLEL_COMPUTING_OPENMP_PRECISION_HPP_
+#define PARALLEL_COMPUTING_OPENMP_PRECISION_HPP_
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+
+// Storage types of values tables narrower than double. Values are widened on load to the
+// accumulator type of their storage: double for double and float, float for the 16-bit types.
+
+namespace my::precision
+{
+
+// IEEE 754 binary16: 5 exponent bits, 10 mantissa bits, maximum finite value 65504
+struct Half
+{
+    std::uint16_t bits;
+};
+
+// Upper half of a binary32: 8 exponent bits, 7 mantissa bits, the same range as float
+struct BFloat16
+{
+    std::uint16_t bits;
+};
+
+namespace detail
+{
+
+template <typename To, typename From>
+inline To bit_cast(const From& from)
+{
+    static_assert(sizeof(To) == sizeof(From));
+    To to;
+    std::memcpy(&to, &from, sizeof(To));
+    return to;
+}
+
+}  // namespace detail
+
+// Exact, written without branches so that loops over tables are vectorized
+inline float to_float(Half value)
+{
+    static constexpr std::uint32_t SHIFTED_EXPONENT_MASK = 0x7C00u << 13;
+    // 2^-14, the implicit bit of subnormals added below
+    static constexpr float MIN_NORMAL = 6.103515625e-05f;
+
+    std::uint32_t sign = (value.bits & 0x8000u) << 16;
+    std::uint32_t bits = (value.bits & 0x7FFFu) << 13;
+    std::uint32_t exponent = bits & SHIFTED_EXPONENT_MASK;
+    // Rebias the exponent from 15 to 127, Inf and NaN get the maximum exponent,
+    // subnormals are normalized by adding the implicit bit and subtracting its value
+    bits += (127 - 15) << 23;
+    bits += (exponent == SHIFTED_EXPONENT_MASK ? (128 - 16) << 23 : 0);
+    bits += (exponent == 0 ? 1u << 23 : 0);
+    float result = detail::bit_cast<float>(bits) - (exponent == 0 ? MIN_NORMAL : 0.0f);
+    return detail::bit_cast<float>(detail::bit_cast<std::uint32_t>(result) | sign);
+}
+
+// Rounds to nearest even, values of at least 65520 in magnitude become infinities
+inline Half to_half(float value)
+{
+    static constexpr std::uint32_t HALF_OVERFLOW = (127 + 16) << 23;
+    static constexpr std::uint32_t FLOAT_INFINITY = 0xFFu << 23;
+    static constexpr std::uint32_t HALF_MIN_NORMAL = 113u << 23;
+    // 0.5f: adding it shifts subnormal halves to the lowest mantissa bits of a float
+    static constexpr std::uint32_t SUBNORMAL_MAGIC = ((127 - 15) + (23 - 10) + 1) << 23;
+
+    std::uint32_t bits = detail::bit_cast<std::uint32_t>(value);
+    std::uint16_t sign = static_cast<std::uint16_t>((bits >> 16) & 0x8000u);
+    bits &= 0x7FFFFFFFu;
+
+    std::uint32_t result;
+    if (bits >= HALF_OVERFLOW)
+    {
+        result = (bits > FLOAT_INFINITY ? 0x7E00u : 0x7C00u);
+    }
+    else if (bits < HALF_MIN_NORMAL)
+    {
+        float shifted = detail::bit_cast<float>(bits) + detail::bit_cast<float>(SUBNORMAL_MAGIC);
+        result = detail::bit_cast<std::uint32_t>(shifted) - SUBNORMAL_MAGIC;
+    }
+    else
+    {
+        std::uint32_t mantissa_odd = (bits >> 13) & 1;
+        bits += ((15u - 127u) << 23) + 0xFFFu + mantissa_odd;
+        result = bits >> 13;
+    }
+    return { static_cast<std::uint16_t>(result | sign) };
+}
+
+inline float to_float(BFloat16 value)
+{
+    return detail::bit_cast<float>(static_cast<std::uint32_t>(value.bits) << 16);
+}
+
+// Rounds to nearest even, NaNs stay quiet NaNs
+inline BFloat16 to_bfloat16(float value)
+{
+    std::uint32_t bits = detail::bit_cast<std::uint32_t>(value);
+    if ((bits & 0x7FFFFFFFu) > 0x7F800000u)
+    {
+        return { static_cast<std::uint16_t>((bits >> 16) | 0x40u) };
+    }
+    bits += 0x7FFFu + ((bits >> 16) & 1);
+    return { static_cast<std::uint16_t>(bits >> 16) };
+}
+
+template <typename Storage>
+struct StorageTraits;
+
+template <>
+struct StorageTraits<double>
+{
+    using accumulator_t = double;
+    static constexpr std::string_view NAME = "double";
+
+    static double load(double value) { return value; }
+    static double store(double value) { return value; }
+};
+
+template <>
+struct StorageTraits<float>
+{
+    using accumulator_t = double;
+    static constexpr std::string_view NAME = "float";
+
+    static double load(float value) { return value; }
+    static float store(double value) { return static_cast<float>(value); }
+};
+
+template <>
+struct StorageTraits<Half>
+{
+    using accumulator_t = float;
+    static constexpr std::string_view NAME = "fp16";
+
+    static float load(Half value) { return to_float(value); }
+    static Half store(double value) { return to_half(static_cast<float>(value)); }
+};
+
+template <>
+struct StorageTraits<BFloat16>
+{
+    using accumulator_t = float;
+    static constexpr std::string_view NAME = "bf16";
+
+    static float load(BFloat16 value) { return to_float(value); }
+    static BFloat16 store(double value) { return to_bfloat16(static_cast<float>(value)); }
+};
+
+// Float accumulators sum at most this many values, their sums are added up in double,
+// so that the error of a float sum does not grow with the size of the table
+inline constexpr std::int64_t FLOAT_BLOCK_SIZE = 1024;
+
+// Vectorized sum of dx * values[i] for i in [0, count) in the accumulator type of Storage
+template <typename Storage>
+double accumulate_simd(const Storage* values, std::int64_t count, double dx)
+{
+    using Traits = StorageTraits<Storage>;
+    using accumulator_t = typename Traits::accumulator_t;
+
+    if constexpr (std::is_same_v<accumulator_t, double>)
+    {
+        double sum = 0;
+        #pragma omp simd reduction(+ : sum)
+        for (std::int64_t i = 0; i < count; ++i)
+        {
+            sum += dx * Traits::load(values[i]);
+        }
+        return sum;
+    }
+    else
+    {
+        double sum = 0;
+        for (std::int64_t first = 0; first < count; first += FLOAT_BLOCK_SIZE)
+        {
+            std::int64_t last = std::min(first + FLOAT_BLOCK_SIZE, count);
+            accumulator_t block_sum = 0;
+            #pragma omp simd reduction(+ : block_sum)
+            for (std::int64_t i = first; i < last; ++i)
+            {
+                block_sum += Traits::load(values[i]);
+            }
+            sum += block_sum;
+        }
+        return dx * sum;
+    }
+}
+
+}  // namespace my::precision
+
+#endif  // PARALLEL_COMPUTING_OPENMP_PRECISION_HPP_
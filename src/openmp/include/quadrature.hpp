@@ -0,0 +1,200 @@
+#ifndef PARALLEL_COMPUTING_OPENMP_QUADRATURE_HPP_
+#define PARALLEL_COMPUTING_OPENMP_QUADRATURE_HPP_
+
+#include <simd_math.hpp>
+
+#include <omp.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// Quadrature rules beyond the left rectangle sum. Table rules take values in equally
+// spaced points from + i * dx, i in [0, count); Gauss rules evaluate a generic kernel
+// (e.g. [](auto x) { return my::simd_math::exp(x); }) in their own nodes.
+
+namespace my::quadrature
+{
+
+// Indices [first, last) of the contiguous block processed by the thread with schedule(static)
+// and no chunk size: both libgomp and LLVM OpenMP give one more iteration to the first
+// count % team_size threads
+struct StaticBlock
+{
+    std::int64_t first;
+    std::int64_t last;
+};
+
+inline StaticBlock static_block(std::int64_t count, std::int64_t thread_id, std::int64_t team_size)
+{
+    std::int64_t size = count / team_size;
+    std::int64_t remainder = count % team_size;
+    std::int64_t first = thread_id * size + std::min(thread_id, remainder);
+    return { .first = first, .last = first + size + (thread_id < remainder ? 1 : 0) };
+}
+
+double trapezoid_simd(const double* values, std::int64_t count, double dx);
+double trapezoid_parallel(const double* values, std::int64_t count, double dx, int thread_count);
+
+// Composite Simpson rule, for an odd number of segments the last three use the 3/8 rule.
+// Falls back to the trapezoid rule for less than three points.
+double simpson_simd(const double* values, std::int64_t count, double dx);
+double simpson_parallel(const double* values, std::int64_t count, double dx, int thread_count);
+
+// Nodes in [-1, 1] and weights of an n-point rule
+struct Rule
+{
+    std::vector<double> nodes;
+    std::vector<double> weights;
+};
+
+// Nodes are the roots of Legendre polynomial P_n found with Newton's method
+Rule gauss_legendre_rule(int points_count);
+
+// Composite Gauss-Legendre rule on segments_count equal segments of [from, to]. The same
+// node of all segments forms an equally spaced grid, which is evaluated a vector at a time.
+template <typename Kernel>
+double gauss_legendre_simd(Kernel kernel, const Rule& rule, double from, double to, std::int64_t segments_count)
+{
+    double h = (to - from) / static_cast<double>(segments_count);
+    double sum = 0;
+    for (std::size_t j = 0; j < rule.nodes.size(); ++j)
+    {
+        double offset = h * (rule.nodes[j] + 1) / 2;
+        sum += rule.weights[j] * my::simd_math::sum_points(kernel, from + offset, h, 0, segments_count);
+    }
+    return h / 2 * sum;
+}
+
+template <typename Kernel>
+double gauss_legendre_parallel(Kernel kernel, const Rule& rule, double from, double to, std::int64_t segments_count, int thread_count)
+{
+    double h = (to - from) / static_cast<double>(segments_count);
+    double sum = 0;
+    omp_set_num_threads(thread_count);
+    #pragma omp parallel reduction(+ : sum)
+    {
+        auto [first, last] = static_block(segments_count, omp_get_thread_num(), omp_get_num_threads());
+        for (std::size_t j = 0; j < rule.nodes.size(); ++j)
+        {
+            double offset = h * (rule.nodes[j] + 1) / 2;
+            sum += rule.weights[j] * my::simd_math::sum_points(kernel, from + offset, h, first, last - first);
+        }
+    }
+    return h / 2 * sum;
+}
+
+struct AdaptiveResult
+{
+    double value;
+    // Sum of |Kronrod - Gauss| over the final intervals, usually a large overestimate
+    double error;
+    std::int64_t evaluations;
+    std::int64_t intervals;
+};
+
+namespace detail
+{
+
+// 7-point Gauss and 15-point Kronrod rules (QUADPACK qk15.f). Odd Kronrod
+// nodes are the Gauss ones, the last node is the center of the interval.
+inline constexpr double KRONROD_NODES[8] = {
+    0.991455371120812639206854697526329, 0.949107912342758524526189684047851,
+    0.864864423359769072789712788640926, 0.741531185599394439863864773280788,
+    0.586087235467691130294144845693013, 0.405845151377397166906606412076961,
+    0.207784955007898467600689403773245, 0.000000000000000000000000000000000,
+};
+inline constexpr double KRONROD_WEIGHTS[8] = {
+    0.022935322010529224963732008058970, 0.063092092629978553290700663189204,
+    0.104790010322250183839876322541518, 0.140653259715525918745189590510238,
+    0.169004726639267902826583426598550, 0.190350578064785409913256402421014,
+    0.204432940075298892414161999234649, 0.209482141084727828012999174891714,
+};
+inline constexpr double GAUSS_WEIGHTS[4] = {
+    0.129484966168869693270611432679082, 0.279705391489276667901467771423780,
+    0.381830050505118944950369775488975, 0.417959183673469387755102040816327,
+};
+
+// Intervals are split into tasks up to this depth, deeper ones are refined by the same task
+inline constexpr int TASK_DEPTH_LIMIT = 12;
+// Intervals are not split any further beyond this depth regardless of the error
+inline constexpr int MAX_DEPTH = 32;
+
+template <typename Kernel>
+AdaptiveResult gauss_kronrod_15(Kernel& kernel, double from, double to)
+{
+    double center = (from + to) / 2;
+    double half_length = (to - from) / 2;
+
+    double center_value = kernel(center);
+    double kronrod = KRONROD_WEIGHTS[7] * center_value;
+    double gauss = GAUSS_WEIGHTS[3] * center_value;
+    for (int i = 0; i < 7; ++i)
+    {
+        double dx = half_length * KRONROD_NODES[i];
+        double pair = kernel(center - dx) + kernel(center + dx);
+        kronrod += KRONROD_WEIGHTS[i] * pair;
+        if (i % 2 == 1)
+        {
+            gauss += GAUSS_WEIGHTS[i / 2] * pair;
+        }
+    }
+    return { .value = kronrod * half_length,
+             .error = std::fabs((kronrod - gauss) * half_length),
+             .evaluations = 15,
+             .intervals = 1 };
+}
+
+// An interval is accepted if its error estimate is within tolerance, otherwise
+// both halves are refined with half of the tolerance each
+template <typename Kernel>
+AdaptiveResult gauss_kronrod_adaptive_step(Kernel& kernel, double from, double to, double tolerance, int depth)
+{
+    AdaptiveResult result = gauss_kronrod_15(kernel, from, to);
+    if (result.error <= tolerance || depth >= MAX_DEPTH)
+    {
+        return result;
+    }
+
+    double center = (from + to) / 2;
+    AdaptiveResult left;
+    AdaptiveResult right;
+    if (depth < TASK_DEPTH_LIMIT)
+    {
+        #pragma omp task default(none) shared(kernel, left) firstprivate(from, center, tolerance, depth)
+        left = gauss_kronrod_adaptive_step(kernel, from, center, tolerance / 2, depth + 1);
+        right = gauss_kronrod_adaptive_step(kernel, center, to, tolerance / 2, depth + 1);
+        #pragma omp taskwait
+    }
+    else
+    {
+        left = gauss_kronrod_adaptive_step(kernel, from, center, tolerance / 2, depth + 1);
+        right = gauss_kronrod_adaptive_step(kernel, center, to, tolerance / 2, depth + 1);
+    }
+    return { .value = left.value + right.value,
+             .error = left.error + right.error,
+             .evaluations = result.evaluations + left.evaluations + right.evaluations,
+             .intervals = left.intervals + right.intervals };
+}
+
+}  // namespace detail
+
+// Adaptive Gauss-Kronrod quadrature: intervals are bisected where the 7-point Gauss and
+// 15-point Kronrod results differ, halves are refined by OpenMP tasks of thread_count threads.
+// The tolerance must stay above the rounding noise of the integrand values summed over the
+// domain, otherwise intervals are bisected down to MAX_DEPTH.
+template <typename Kernel>
+AdaptiveResult gauss_kronrod_adaptive(Kernel kernel, double from, double to, double tolerance, int thread_count)
+{
+    AdaptiveResult result;
+    omp_set_num_threads(thread_count);
+    #pragma omp parallel
+    #pragma omp single
+    result = detail::gauss_kronrod_adaptive_step(kernel, from, to, tolerance, 0);
+    return result;
+}
+
+}  // namespace my::quadrature
+
+#endif  // PARALLEL_COMPUTING_OPENMP_QUADRATURE_HPP_
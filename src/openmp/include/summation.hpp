@@ -0,0 +1,155 @@
+#ifndef PARALLEL_COMPUTING_OPENMP_SUMMATION_HPP_
+#define PARALLEL_COMPUTING_OPENMP_SUMMATION_HPP_
+
+#include <cmath>
+#include <cstdint>
+
+// Accumulators that lose less precision than plain summation, each one can be used as
+// an OpenMP reduction variable (see the declare reduction directives at the bottom):
+//
+//     my::summation::NeumaierSum sum;
+//     #pragma omp parallel for reduction(neumaier : sum)
+//     for (std::int64_t i = 0; i < count; ++i)
+//     {
+//         sum.add(values[i]);
+//     }
+//
+// Compensation terms rely on the exact order of floating-point operations, so code using
+// them must not be compiled with -ffast-math or -fassociative-math.
+
+namespace my::summation
+{
+
+// Kahan summation: the rounding error of every addition is subtracted from the next term
+class KahanSum
+{
+public:
+    void add(double value)
+    {
+        double corrected = value - m_compensation;
+        double sum = m_sum + corrected;
+        m_compensation = (sum - m_sum) - corrected;
+        m_sum = sum;
+    }
+
+    void merge(const KahanSum& other)
+    {
+        add(other.m_sum);
+        add(-other.m_compensation);
+    }
+
+    double value() const
+    {
+        return m_sum - m_compensation;
+    }
+
+private:
+    double m_sum = 0;
+    double m_compensation = 0;
+};
+
+// Neumaier's variant of Kahan summation, which also handles terms larger than the sum.
+// Error bound barely depends on the number of terms.
+class NeumaierSum
+{
+public:
+    void add(double value)
+    {
+        double sum = m_sum + value;
+        m_compensation += (std::fabs(m_sum) >= std::fabs(value) ? (m_sum - sum) + value : (value - sum) + m_sum);
+        m_sum = sum;
+    }
+
+    void merge(const NeumaierSum& other)
+    {
+        add(other.m_sum);
+        m_compensation += other.m_compensation;
+    }
+
+    double value() const
+    {
+        return m_sum + m_compensation;
+    }
+
+private:
+    double m_sum = 0;
+    double m_compensation = 0;
+};
+
+// Pairwise (cascade) summation: BLOCK_SIZE terms are summed directly, then block sums
+// are combined like digits of a binary counter, so only sums of the same number of blocks
+// are added together. Error grows as log2 of the number of terms.
+class PairwiseSum
+{
+public:
+    void add(double value)
+    {
+        m_block += value;
+        if (++m_block_size == BLOCK_SIZE)
+        {
+            push(m_block, 0);
+            m_block = 0;
+            m_block_size = 0;
+        }
+    }
+
+    void merge(const PairwiseSum& other)
+    {
+        for (int level = 0; level < LEVELS_COUNT; ++level)
+        {
+            if (other.m_occupied & (std::uint64_t{ 1 } << level))
+            {
+                push(other.m_levels[level], level);
+            }
+        }
+        push(other.m_block, 0);
+    }
+
+    double value() const
+    {
+        double sum = m_block;
+        for (int level = 0; level < LEVELS_COUNT; ++level)
+        {
+            if (m_occupied & (std::uint64_t{ 1 } << level))
+            {
+                sum += m_levels[level];
+            }
+        }
+        return sum;
+    }
+
+private:
+    static constexpr int BLOCK_SIZE = 64;
+    static constexpr int LEVELS_COUNT = 64;
+
+    // Sum of 2^level blocks
+    void push(double sum, int level)
+    {
+        while (level + 1 < LEVELS_COUNT && (m_occupied & (std::uint64_t{ 1 } << level)))
+        {
+            sum += m_levels[level];
+            m_occupied &= ~(std::uint64_t{ 1 } << level);
+            ++level;
+        }
+        m_levels[level] = sum;
+        m_occupied |= std::uint64_t{ 1 } << level;
+    }
+
+    double m_levels[LEVELS_COUNT] = {};
+    std::uint64_t m_occupied = 0;
+    double m_block = 0;
+    int m_block_size = 0;
+};
+
+// Sum that is bit-identical for any thread count: values are split into chunks of fixed
+// size independent of the team, chunks are summed by any thread, and chunk sums are added
+// up in their order by one thread
+double reproducible_sum(const double* values, std::int64_t count, int thread_count);
+
+}  // namespace my::summation
+
+#pragma omp declare reduction(kahan : my::summation::KahanSum : omp_out.merge(omp_in)) initializer(omp_priv = my::summation::KahanSum())
+#pragma omp declare reduction(neumaier : my::summation::NeumaierSum : omp_out.merge(omp_in)) initializer(omp_priv = my::summation::NeumaierSum())
+#pragma omp declare reduction(pairwise : my::summation::PairwiseSum : omp_out.merge(omp_in)) initializer(omp_priv = my::summation::PairwiseSum())
+
+#endif  // PARALLEL_COMPUTING_OPENMP_SUMMATION_HPP_
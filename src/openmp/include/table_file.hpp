@@ -0,0 +1,92 @@
+#ifndef PARALLEL_COMPUTING_OPENMP_TABLE_FILE_HPP_
+#define PARALLEL_COMPUTING_OPENMP_TABLE_FILE_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+// Tables of function values stored in files, so that they do not have to fit in memory.
+// A file consists of TableFileHeader followed by points_count doubles in the byte order
+// of the host, values are taken in points from + i * dx.
+
+namespace my::table_file
+{
+
+struct TableFileHeader
+{
+    static constexpr char MAGIC[8] = { 'P', 'C', 'T', 'A', 'B', 'L', 'E', '1' };
+
+    char magic[8];
+    std::uint64_t points_count;
+    double from;
+    double dx;
+    // Pads the header to a cache line, so that values are aligned in the mapping
+    std::uint8_t reserved[32];
+};
+
+static_assert(sizeof(TableFileHeader) == 64);
+
+// Values are appended in chunks, the header is written on close
+class TableFileWriter
+{
+public:
+    TableFileWriter(const std::string& path, double from, double dx);
+    ~TableFileWriter();
+
+    TableFileWriter(const TableFileWriter&) = delete;
+    TableFileWriter& operator=(const TableFileWriter&) = delete;
+
+    void append(const double* values, std::int64_t count);
+    void close();
+
+private:
+    std::string m_path;
+    std::ofstream m_out;
+    TableFileHeader m_header;
+};
+
+// Read-only mapping of a whole table file with sequential access advice
+class MappedTable
+{
+public:
+    explicit MappedTable(const std::string& path);
+    ~MappedTable();
+
+    MappedTable(const MappedTable&) = delete;
+    MappedTable& operator=(const MappedTable&) = delete;
+
+    const TableFileHeader& header() const
+    {
+        return *static_cast<const TableFileHeader*>(m_data);
+    }
+
+    const double* values() const
+    {
+        return reinterpret_cast<const double*>(static_cast<const char*>(m_data) + sizeof(TableFileHeader));
+    }
+
+    std::int64_t size() const
+    {
+        return static_cast<std::int64_t>(header().points_count);
+    }
+
+private:
+    void* m_data;
+    std::size_t m_length;
+};
+
+TableFileHeader read_header(const std::string& path);
+
+// Left rectangle sum over the mapped table. Every thread sums its static block window by
+// window and advises the kernel to read the next window ahead (MADV_WILLNEED) and to drop
+// the mapping of the summed one (MADV_DONTNEED), so the resident set stays small.
+double integrate_mapped_parallel(const MappedTable& table, std::int64_t window_size, int thread_count);
+
+// Left rectangle sum of the table file read with pread in chunks into two buffers: the next
+// chunk is read by a separate thread while the OpenMP team sums the current one
+double integrate_streaming_parallel(const std::string& path, std::int64_t chunk_size, int thread_count);
+
+}  // namespace my::table_file
+
+#endif  // PARALLEL_COMPUTING_OPENMP_TABLE_FILE_HPP_
@@ -0,0 +1,253 @@
+#include <integration_kernels.hpp>
+
+#include <immintrin.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+namespace my::kernels
+{
+
+namespace
+{
+
+// Independent accumulators per kernel: vector addition and FMA have a latency of 4 cycles
+// and a throughput of 2 per cycle on recent cores, so 8 chains keep both ports busy
+constexpr int ACCUMULATORS_COUNT = 8;
+// Software prefetch distance in elements (2 KiB), roughly the memory latency times the
+// bandwidth of one core
+constexpr std::int64_t PREFETCH_DISTANCE = 256;
+constexpr std::int64_t CACHE_LINE_SIZE = 64;
+
+// Number of leading elements to process one by one before values + count is aligned to alignment bytes
+std::int64_t unaligned_head_count(const double* values, std::int64_t count, std::size_t alignment)
+{
+    std::size_t misalignment = reinterpret_cast<std::uintptr_t>(values) % alignment;
+    std::int64_t head = (misalignment == 0 ? 0 : static_cast<std::int64_t>((alignment - misalignment) / sizeof(double)));
+    return std::min(head, count);
+}
+
+double integrate_scalar(const double* values, std::int64_t first, std::int64_t last, double dx)
+{
+    double sum = 0;
+    for (std::int64_t i = first; i < last; ++i)
+    {
+        sum += dx * values[i];
+    }
+    return sum;
+}
+
+// Prefetches cache lines of the block of BLOCK_SIZE elements which is processed PREFETCH_DISTANCE ahead of i
+template <std::int64_t BLOCK_SIZE>
+inline __attribute__((always_inline)) void prefetch_block(const double* values, std::int64_t i, std::int64_t count)
+{
+    static constexpr std::int64_t LINE_ELEMENTS = CACHE_LINE_SIZE / sizeof(double);
+    if (i + PREFETCH_DISTANCE + BLOCK_SIZE <= count)
+    {
+        for (std::int64_t line = 0; line < BLOCK_SIZE; line += LINE_ELEMENTS)
+        {
+            _mm_prefetch(reinterpret_cast<const char*>(values + i + PREFETCH_DISTANCE + line), _MM_HINT_T0);
+        }
+    }
+}
+
+// Every kernel processes the unaligned head with scalar code, then blocks of ACCUMULATORS_COUNT
+// vectors with aligned loads, single vectors and finally the scalar tail. Accumulators are
+// added up pairwise.
+
+double integrate_sse2(const double* values, std::int64_t count, double dx)
+{
+    static constexpr std::int64_t LANES = 2;
+    static constexpr std::int64_t BLOCK_SIZE = LANES * ACCUMULATORS_COUNT;
+
+    std::int64_t i = unaligned_head_count(values, count, sizeof(__m128d));
+    double sum = integrate_scalar(values, 0, i, dx);
+
+    const __m128d step = _mm_set1_pd(dx);
+    __m128d accumulators[ACCUMULATORS_COUNT];
+    for (__m128d& accumulator : accumulators)
+    {
+        accumulator = _mm_setzero_pd();
+    }
+    for (; i + BLOCK_SIZE <= count; i += BLOCK_SIZE)
+    {
+        prefetch_block<BLOCK_SIZE>(values, i, count);
+        for (int k = 0; k < ACCUMULATORS_COUNT; ++k)
+        {
+            accumulators[k] = _mm_add_pd(accumulators[k], _mm_mul_pd(_mm_load_pd(values + i + k * LANES), step));
+        }
+    }
+    for (; i + LANES <= count; i += LANES)
+    {
+        accumulators[0] = _mm_add_pd(accumulators[0], _mm_mul_pd(_mm_load_pd(values + i), step));
+    }
+
+    for (int width = ACCUMULATORS_COUNT / 2; width > 0; width /= 2)
+    {
+        for (int k = 0; k < width; ++k)
+        {
+            accumulators[k] = _mm_add_pd(accumulators[k], accumulators[k + width]);
+        }
+    }
+    __m128d vector_sum = accumulators[0];
+    sum += _mm_cvtsd_f64(_mm_add_sd(vector_sum, _mm_unpackhi_pd(vector_sum, vector_sum)));
+    return sum + integrate_scalar(values, i, count, dx);
+}
+
+__attribute__((target("avx2,fma"))) double integrate_avx2(const double* values, std::int64_t count, double dx)
+{
+    static constexpr std::int64_t LANES = 4;
+    static constexpr std::int64_t BLOCK_SIZE = LANES * ACCUMULATORS_COUNT;
+
+    std::int64_t i = unaligned_head_count(values, count, sizeof(__m256d));
+    double sum = integrate_scalar(values, 0, i, dx);
+
+    const __m256d step = _mm256_set1_pd(dx);
+    __m256d accumulators[ACCUMULATORS_COUNT];
+    for (__m256d& accumulator : accumulators)
+    {
+        accumulator = _mm256_setzero_pd();
+    }
+    for (; i + BLOCK_SIZE <= count; i += BLOCK_SIZE)
+    {
+        prefetch_block<BLOCK_SIZE>(values, i, count);
+        for (int k = 0; k < ACCUMULATORS_COUNT; ++k)
+        {
+            accumulators[k] = _mm256_fmadd_pd(_mm256_load_pd(values + i + k * LANES), step, accumulators[k]);
+        }
+    }
+    for (; i + LANES <= count; i += LANES)
+    {
+        accumulators[0] = _mm256_fmadd_pd(_mm256_load_pd(values + i), step, accumulators[0]);
+    }
+
+    for (int width = ACCUMULATORS_COUNT / 2; width > 0; width /= 2)
+    {
+        for (int k = 0; k < width; ++k)
+        {
+            accumulators[k] = _mm256_add_pd(accumulators[k], accumulators[k + width]);
+        }
+    }
+    __m128d half_sum = _mm_add_pd(_mm256_castpd256_pd128(accumulators[0]), _mm256_extractf128_pd(accumulators[0], 1));
+    sum += _mm_cvtsd_f64(_mm_add_sd(half_sum, _mm_unpackhi_pd(half_sum, half_sum)));
+    return sum + integrate_scalar(values, i, count, dx);
+}
+
+__attribute__((target("avx512f"))) double integrate_avx512(const double* values, std::int64_t count, double dx)
+{
+    static constexpr std::int64_t LANES = 8;
+    static constexpr std::int64_t BLOCK_SIZE = LANES * ACCUMULATORS_COUNT;
+    // Masked forms of the lane extraction keep GCC from warning about uninitialized intrinsic arguments
+    static constexpr __mmask8 ALL_LANES = 0xFF;
+
+    std::int64_t i = unaligned_head_count(values, count, sizeof(__m512d));
+    double sum = integrate_scalar(values, 0, i, dx);
+
+    const __m512d step = _mm512_set1_pd(dx);
+    __m512d accumulators[ACCUMULATORS_COUNT];
+    for (__m512d& accumulator : accumulators)
+    {
+        accumulator = _mm512_setzero_pd();
+    }
+    for (; i + BLOCK_SIZE <= count; i += BLOCK_SIZE)
+    {
+        prefetch_block<BLOCK_SIZE>(values, i, count);
+        for (int k = 0; k < ACCUMULATORS_COUNT; ++k)
+        {
+            accumulators[k] = _mm512_fmadd_pd(_mm512_load_pd(values + i + k * LANES), step, accumulators[k]);
+        }
+    }
+    for (; i + LANES <= count; i += LANES)
+    {
+        accumulators[0] = _mm512_fmadd_pd(_mm512_load_pd(values + i), step, accumulators[0]);
+    }
+
+    for (int width = ACCUMULATORS_COUNT / 2; width > 0; width /= 2)
+    {
+        for (int k = 0; k < width; ++k)
+        {
+            accumulators[k] = _mm512_add_pd(accumulators[k], accumulators[k + width]);
+        }
+    }
+    __m256d low = _mm512_mask_extractf64x4_pd(_mm256_setzero_pd(), ALL_LANES, accumulators[0], 0);
+    __m256d quarter_sum = _mm256_add_pd(low, _mm512_mask_extractf64x4_pd(low, ALL_LANES, accumulators[0], 1));
+    __m128d half_sum = _mm_add_pd(_mm256_castpd256_pd128(quarter_sum), _mm256_extractf128_pd(quarter_sum, 1));
+    sum += _mm_cvtsd_f64(_mm_add_sd(half_sum, _mm_unpackhi_pd(half_sum, half_sum)));
+    return sum + integrate_scalar(values, i, count, dx);
+}
+
+// __builtin_cpu_supports also checks that the OS saves the corresponding vector registers
+bool is_supported(Isa isa)
+{
+    switch (isa)
+    {
+    case Isa::SSE2:
+        return true;
+    case Isa::AVX2:
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    case Isa::AVX512:
+        return __builtin_cpu_supports("avx512f");
+    }
+    return false;
+}
+
+}  // namespace
+
+std::string_view to_string(Isa isa)
+{
+    switch (isa)
+    {
+    case Isa::SSE2:
+        return "sse2";
+    case Isa::AVX2:
+        return "avx2";
+    case Isa::AVX512:
+        return "avx-512";
+    }
+    throw std::invalid_argument("Unknown instruction set " + std::to_string(static_cast<int>(isa)));
+}
+
+const std::vector<Isa>& supported_isas()
+{
+    static const std::vector<Isa> isas = []()
+    {
+        std::vector<Isa> result;
+        for (Isa isa : { Isa::SSE2, Isa::AVX2, Isa::AVX512 })
+        {
+            if (is_supported(isa))
+            {
+                result.push_back(isa);
+            }
+        }
+        return result;
+    }();
+    return isas;
+}
+
+integrate_kernel_t integrate_kernel(Isa isa)
+{
+    if (!is_supported(isa))
+    {
+        throw std::invalid_argument("Instruction set " + std::string(to_string(isa)) + " is not supported by the CPU");
+    }
+    switch (isa)
+    {
+    case Isa::SSE2:
+        return integrate_sse2;
+    case Isa::AVX2:
+        return integrate_avx2;
+    case Isa::AVX512:
+        return integrate_avx512;
+    }
+    throw std::invalid_argument("Unknown instruction set " + std::to_string(static_cast<int>(isa)));
+}
+
+integrate_kernel_t best_integrate_kernel()
+{
+    return integrate_kernel(supported_isas().back());
+}
+
+}  // namespace my::kernels
@@ -1,23 +1,67 @@
+#include <batch.hpp>
 #include <benchmark.hpp>
+#include <integration_kernels.hpp>
+#include <parallel_backends.hpp>
+#include <perf_counters.hpp>
+#include <precision.hpp>
+#include <quadrature.hpp>
+#include <simd_math.hpp>
+#include <summation.hpp>
+#include <table_file.hpp>
+#include <topology.hpp>
 
 #include <omp.h>
 
+#include <algorithm>
 #include <cmath>
+#include <exception>
 #include <functional>
 #include <iomanip>
 #include <iostream>
-#include <numeric>
+#include <memory>
+#include <optional>
+#include <random>
+#include <sstream>
 #include <string>
 #include <string_view>
+#include <type_traits>
+#include <utility>
+#include <variant>
 #include <vector>
 
 namespace
 {
 
-using arithmetic_function_t = std::function<double(double)>;
-using function_values_table_t = std::vector<double>;
+// Leaves elements uninitialized on construction and resize, so that pages of a table
+// are first touched by the threads filling it rather than by the allocating thread
+template <typename T>
+struct DefaultInitAllocator : std::allocator<T>
+{
+    template <typename U>
+    struct rebind
+    {
+        using other = DefaultInitAllocator<U>;
+    };
+
+    using std::allocator<T>::allocator;
+
+    template <typename U>
+    void construct(U* pointer) noexcept(std::is_nothrow_default_constructible_v<U>)
+    {
+        ::new (static_cast<void*>(pointer)) U;
+    }
+
+    template <typename U, typename... Args>
+    void construct(U* pointer, Args&&... args)
+    {
+        ::new (static_cast<void*>(pointer)) U(std::forward<Args>(args)...);
+    }
+};
 
-using integrate_function_t = std::function<double(const function_values_table_t& table, double dx)>;
+using arithmetic_function_t = std::function<double(double)>;
+template <typename Storage>
+using values_table_t = std::vector<Storage, DefaultInitAllocator<Storage>>;
+using function_values_table_t = values_table_t<double>;
 
 double integrate_dummy(const function_values_table_t& table, double dx)
 {
@@ -31,120 +75,1250 @@ double integrate_dummy(const function_values_table_t& table, double dx)
     return sum;
 }
 
-double integrate_omp_parallel(const function_values_table_t& table, double dx, int thread_count)
+// Table variants are templated on the storage type of values, see precision.hpp
+
+template <typename Storage>
+double integrate_omp_parallel(const values_table_t<Storage>& table, double dx, int thread_count)
 {
+    using Traits = my::precision::StorageTraits<Storage>;
     asm volatile("# integrate_omp_parallel enter");
     double sum = 0;
     omp_set_num_threads(thread_count);
     std::int64_t size = static_cast<std::int64_t>(table.size());
-    // OpenMP restricts:
-    // - the loop variable to be a signed integer
-    // - the predicate to be < instead of !=
-    #pragma omp parallel for reduction(+ : sum)
-    for (std::int64_t i = 0; i < size; ++i)
+    if constexpr (std::is_same_v<typename Traits::accumulator_t, double>)
     {
-        sum += dx * table[i];
+        // OpenMP restricts:
+        // - the loop variable to be a signed integer
+        // - the predicate to be < instead of !=
+        // Static schedule keeps the table pages generated by a thread local to it,
+        // see generate_function_values_table_first_touch
+        #pragma omp parallel for schedule(static) reduction(+ : sum)
+        for (std::int64_t i = 0; i < size; ++i)
+        {
+            sum += dx * Traits::load(table[i]);
+        }
+    }
+    else
+    {
+        // Float accumulators sum blocks of the same partition
+        #pragma omp parallel reduction(+ : sum)
+        {
+            auto [first, last] = my::quadrature::static_block(size, omp_get_thread_num(), omp_get_num_threads());
+            sum += my::precision::accumulate_simd(table.data() + first, last - first, dx);
+        }
     }
     asm volatile("# integrate_omp_parallel exit");
     return sum;
 }
 
-double integrate_omp_simd(const function_values_table_t& table, double dx)
+template <typename Storage>
+double integrate_omp_simd(const values_table_t<Storage>& table, double dx)
 {
     asm volatile("# integrate_omp_simd enter");
+    double sum = my::precision::accumulate_simd(table.data(), static_cast<std::int64_t>(table.size()), dx);
+    asm volatile("# integrate_omp_simd exit");
+    return sum;
+}
+
+// Explicit vector kernel of the widest instruction set supported by the CPU, every thread
+// integrates the same block as with schedule(static)
+double integrate_kernel_parallel(const function_values_table_t& table, double dx, int thread_count)
+{
+    asm volatile("# integrate_kernel_parallel enter");
+    static const my::kernels::integrate_kernel_t kernel = my::kernels::best_integrate_kernel();
     double sum = 0;
+    omp_set_num_threads(thread_count);
+    std::int64_t size = static_cast<std::int64_t>(table.size());
+    #pragma omp parallel reduction(+ : sum)
+    {
+        auto [first, last] = my::quadrature::static_block(size, omp_get_thread_num(), omp_get_num_threads());
+        sum += kernel(table.data() + first, last - first, dx);
+    }
+    asm volatile("# integrate_kernel_parallel exit");
+    return sum;
+}
+
+// Compensated and pairwise variants sum the table values with custom reductions
+// from summation.hpp and multiply the sum by dx once
+
+double integrate_kahan_parallel(const function_values_table_t& table, double dx, int thread_count)
+{
+    asm volatile("# integrate_kahan_parallel enter");
+    my::summation::KahanSum sum;
+    omp_set_num_threads(thread_count);
+    std::int64_t size = static_cast<std::int64_t>(table.size());
+    #pragma omp parallel for schedule(static) reduction(kahan : sum)
+    for (std::int64_t i = 0; i < size; ++i)
+    {
+        sum.add(table[i]);
+    }
+    asm volatile("# integrate_kahan_parallel exit");
+    return dx * sum.value();
+}
+
+double integrate_neumaier_parallel(const function_values_table_t& table, double dx, int thread_count)
+{
+    asm volatile("# integrate_neumaier_parallel enter");
+    my::summation::NeumaierSum sum;
+    omp_set_num_threads(thread_count);
+    std::int64_t size = static_cast<std::int64_t>(table.size());
+    #pragma omp parallel for schedule(static) reduction(neumaier : sum)
+    for (std::int64_t i = 0; i < size; ++i)
+    {
+        sum.add(table[i]);
+    }
+    asm volatile("# integrate_neumaier_parallel exit");
+    return dx * sum.value();
+}
+
+double integrate_pairwise_parallel(const function_values_table_t& table, double dx, int thread_count)
+{
+    asm volatile("# integrate_pairwise_parallel enter");
+    my::summation::PairwiseSum sum;
+    omp_set_num_threads(thread_count);
     std::int64_t size = static_cast<std::int64_t>(table.size());
-    // OpenMP restricts:
-    // - the loop variable to be a signed integer
-    // - the predicate to be < instead of !=
+    #pragma omp parallel for schedule(static) reduction(pairwise : sum)
+    for (std::int64_t i = 0; i < size; ++i)
+    {
+        sum.add(table[i]);
+    }
+    asm volatile("# integrate_pairwise_parallel exit");
+    return dx * sum.value();
+}
+
+// Bit-identical result for any thread_count
+double integrate_reproducible_parallel(const function_values_table_t& table, double dx, int thread_count)
+{
+    asm volatile("# integrate_reproducible_parallel enter");
+    double sum = my::summation::reproducible_sum(table.data(), static_cast<std::int64_t>(table.size()), thread_count);
+    asm volatile("# integrate_reproducible_parallel exit");
+    return dx * sum;
+}
+
+double arithmetic_function(double x)
+{
+    return std::exp(std::sin(std::pow(x, M_PI)));
+}
+
+// Same as arithmetic_function for double, __m256d or __m512d with polynomial
+// approximations instead of libm, see simd_math.hpp for their accuracy
+const auto simd_arithmetic_function = [](auto x)
+{
+    return my::simd_math::exp(my::simd_math::sin(my::simd_math::pow(x, M_PI)));
+};
+
+// arithmetic_function with the exponent as a parameter, for batches of integrals
+const auto simd_parametrized_function = [](auto x, auto parameter)
+{
+    return my::simd_math::exp(my::simd_math::sin(my::simd_math::pow(x, parameter)));
+};
+
+// Points from, from + dx, from + 2dx, ..., points_count in total
+struct Domain
+{
+    double from;
+    double dx;
+    std::int64_t points_count;
+
+    double point(std::int64_t i) const
+    {
+        return from + static_cast<double>(i) * dx;
+    }
+};
+
+Domain make_domain(double from, double to, double dx)
+{
+    return { .from = from, .dx = dx, .points_count = static_cast<std::int64_t>((to - from) / dx) + 1 };
+}
+
+// Fused variants evaluate arithmetic_function right in the integration loop instead
+// of reading a table of its values, trading memory bandwidth for computations
+
+double integrate_fused_dummy(const Domain& domain)
+{
+    asm volatile("# integrate_fused_dummy enter");
+    double sum = 0;
+    for (std::int64_t i = 0; i < domain.points_count; ++i)
+    {
+        sum += domain.dx * arithmetic_function(domain.point(i));
+    }
+    asm volatile("# integrate_fused_dummy exit");
+    return sum;
+}
+
+double integrate_fused_omp_simd(const Domain& domain)
+{
+    asm volatile("# integrate_fused_omp_simd enter");
+    double sum = 0;
     #pragma omp simd reduction(+ : sum)
+    for (std::int64_t i = 0; i < domain.points_count; ++i)
+    {
+        sum += domain.dx * arithmetic_function(domain.point(i));
+    }
+    asm volatile("# integrate_fused_omp_simd exit");
+    return sum;
+}
+
+double integrate_fused_omp_parallel(const Domain& domain, int thread_count)
+{
+    asm volatile("# integrate_fused_omp_parallel enter");
+    double sum = 0;
+    omp_set_num_threads(thread_count);
+    #pragma omp parallel for reduction(+ : sum)
+    for (std::int64_t i = 0; i < domain.points_count; ++i)
+    {
+        sum += domain.dx * arithmetic_function(domain.point(i));
+    }
+    asm volatile("# integrate_fused_omp_parallel exit");
+    return sum;
+}
+
+// SIMD variants evaluate a vector of points at a time with the widest instruction
+// set available, the remainder is evaluated with scalar versions of the same kernels
+
+double integrate_fused_simd(const Domain& domain)
+{
+    asm volatile("# integrate_fused_simd enter");
+    double sum = my::simd_math::sum_points(simd_arithmetic_function, domain.from, domain.dx, 0, domain.points_count);
+    asm volatile("# integrate_fused_simd exit");
+    return domain.dx * sum;
+}
+
+double integrate_fused_simd_parallel(const Domain& domain, int thread_count)
+{
+    asm volatile("# integrate_fused_simd_parallel enter");
+    double sum = 0;
+    omp_set_num_threads(thread_count);
+    #pragma omp parallel reduction(+ : sum)
+    {
+        auto [first, last] = my::quadrature::static_block(domain.points_count, omp_get_thread_num(), omp_get_num_threads());
+        sum += my::simd_math::sum_points(simd_arithmetic_function, domain.from, domain.dx, first, last - first);
+    }
+    asm volatile("# integrate_fused_simd_parallel exit");
+    return domain.dx * sum;
+}
+
+// Worksharing schedule set with omp_set_schedule for loops with schedule(runtime),
+// chunk size 0 selects the default chunk of the kind
+struct Schedule
+{
+    omp_sched_t kind;
+    int chunk_size;
+};
+
+std::string to_string(const Schedule& schedule)
+{
+    std::string kind = (schedule.kind == omp_sched_static ? "static" : schedule.kind == omp_sched_dynamic ? "dynamic" : "guided");
+    return schedule.chunk_size == 0 ? kind : kind + "," + std::to_string(schedule.chunk_size);
+}
+
+// Same as integrate_omp_parallel with the schedule set by omp_set_schedule
+double integrate_omp_parallel_runtime(const function_values_table_t& table, double dx, int thread_count)
+{
+    asm volatile("# integrate_omp_parallel_runtime enter");
+    double sum = 0;
+    omp_set_num_threads(thread_count);
+    std::int64_t size = static_cast<std::int64_t>(table.size());
+    #pragma omp parallel for schedule(runtime) reduction(+ : sum)
     for (std::int64_t i = 0; i < size; ++i)
     {
         sum += dx * table[i];
     }
-    asm volatile("# integrate_omp_simd exit");
+    asm volatile("# integrate_omp_parallel_runtime exit");
     return sum;
 }
 
-double arithmetic_function(double x)
+void empty_parallel_region(int thread_count)
 {
-    return std::exp(std::sin(std::pow(x, M_PI)));
+    #pragma omp parallel num_threads(thread_count)
+    {
+        asm volatile("");
+    }
 }
 
-my::TicksAndNanoseconds measure_integrate(integrate_function_t integrate, const function_values_table_t& table, double dx)
+struct PersistentRegionResult
 {
-    static constexpr std::size_t ITERATIONS_COUNT = 10'000;
-    std::vector<my::TicksAndNanoseconds> results(ITERATIONS_COUNT);
-    for (my::TicksAndNanoseconds& result : results)
+    // Worksharing loop followed by a barrier, measured by the master thread
+    my::BenchmarkResult iteration;
+    // Time the slowest thread spends in its chunks of the loop
+    my::BenchmarkResult kernel;
+    // Rest of the iteration: barrier, reduction and load imbalance
+    my::BenchmarkResult barrier;
+};
+
+// Runs warmup and timed iterations of integrate_omp_parallel_runtime inside a single
+// parallel region, so that threads are forked and joined once for all of them
+PersistentRegionResult measure_persistent_region(const function_values_table_t& table, double dx, int thread_count,
+                                                 const my::BenchmarkParams& params)
+{
+    std::size_t iterations_count = params.warmup_count + params.samples_count;
+    std::vector<my::TicksAndNanoseconds> iteration_samples(iterations_count);
+    std::vector<double> kernel_ticks(iterations_count);
+    std::vector<std::uint64_t> thread_ticks(thread_count);
+    std::optional<my::Timer> timer;
+    std::int64_t size = static_cast<std::int64_t>(table.size());
+    double sum = 0;
+
+    #pragma omp parallel num_threads(thread_count)
     {
-        my::Timer timer(result);
-        double integrate_result = integrate(table, dx);
-        my::do_not_optimize(integrate_result);
+        int thread_id = omp_get_thread_num();
+        for (std::size_t iteration = 0; iteration < iterations_count; ++iteration)
+        {
+            #pragma omp barrier
+            #pragma omp master
+            timer.emplace(iteration_samples[iteration]);
+
+            std::uint64_t ticks_before = my::ticks_begin();
+            double thread_sum = 0;
+            #pragma omp for schedule(runtime) nowait
+            for (std::int64_t i = 0; i < size; ++i)
+            {
+                thread_sum += dx * table[i];
+            }
+            thread_ticks[thread_id] = my::ticks_end() - ticks_before;
+            #pragma omp atomic
+            sum += thread_sum;
+            #pragma omp barrier
+
+            #pragma omp master
+            {
+                timer.reset();
+                kernel_ticks[iteration] = static_cast<double>(*std::max_element(thread_ticks.begin(), thread_ticks.end()));
+                my::do_not_optimize(sum);
+                sum = 0;
+            }
+        }
     }
-    my::TicksAndNanoseconds results_sum = std::accumulate(results.begin(), results.end(), my::TicksAndNanoseconds{ 0, 0 },
-                                                      [](const my::TicksAndNanoseconds& a, const my::TicksAndNanoseconds& b) -> my::TicksAndNanoseconds
-                                                      {
-                                                          return { .ticks = a.ticks + b.ticks,
-                                                                   .nanoseconds = a.nanoseconds + b.nanoseconds };
-                                                      });
-    return { .ticks = results_sum.ticks / ITERATIONS_COUNT,
-             .nanoseconds = results_sum.nanoseconds / ITERATIONS_COUNT };
+
+    // Samples of warmup iterations are dropped
+    const my::TscClock& clock = my::TscClock::get_instance();
+    std::vector<double> samples[6];
+    for (std::size_t iteration = params.warmup_count; iteration < iterations_count; ++iteration)
+    {
+        const my::TicksAndNanoseconds& sample = iteration_samples[iteration];
+        double kernel_nanoseconds = clock.ticks_to_nanoseconds(kernel_ticks[iteration]);
+        samples[0].push_back(sample.ticks);
+        samples[1].push_back(sample.nanoseconds);
+        samples[2].push_back(kernel_ticks[iteration]);
+        samples[3].push_back(kernel_nanoseconds);
+        samples[4].push_back(sample.ticks - kernel_ticks[iteration]);
+        samples[5].push_back(sample.nanoseconds - kernel_nanoseconds);
+    }
+
+    auto statistics = [&params, &samples](std::size_t index) -> my::BenchmarkResult
+    {
+        return { .ticks = my::compute_statistics(std::move(samples[index]), params.reject_outliers),
+                 .nanoseconds = my::compute_statistics(std::move(samples[index + 1]), params.reject_outliers) };
+    };
+    return { .iteration = statistics(0), .kernel = statistics(2), .barrier = statistics(4) };
 }
 
-void print_table_row(std::string_view label, my::TicksAndNanoseconds result)
+// Fused integration evaluates the function in every point, so it is
+// measured with fewer samples to keep the sample run time reasonable
+static constexpr my::BenchmarkParams TABLE_PARAMS = { .warmup_count = 100, .samples_count = 10'000 };
+static constexpr my::BenchmarkParams FUSED_PARAMS = { .warmup_count = 2, .samples_count = 20 };
+
+// Schedules are compared with one sweep per thread count, each one measures two variants
+static constexpr my::BenchmarkParams SCHEDULE_PARAMS = { .warmup_count = 10, .samples_count = 100 };
+static constexpr Schedule SCHEDULES[] = {
+    { .kind = omp_sched_static, .chunk_size = 0 },
+    { .kind = omp_sched_static, .chunk_size = 4096 },
+    { .kind = omp_sched_dynamic, .chunk_size = 256 },
+    { .kind = omp_sched_dynamic, .chunk_size = 4096 },
+    { .kind = omp_sched_dynamic, .chunk_size = 65536 },
+    { .kind = omp_sched_guided, .chunk_size = 256 },
+    { .kind = omp_sched_guided, .chunk_size = 4096 },
+};
+
+// Jobs have random bounds within [0, BATCH_MAX_TO] and random exponents, so their
+// lengths differ by up to BATCH_MAX_LENGTH / BATCH_MIN_LENGTH times
+static constexpr std::size_t BATCH_JOBS_COUNT = 4096;
+static constexpr double BATCH_DX = 0.01;
+static constexpr double BATCH_MIN_LENGTH = 0.1;
+static constexpr double BATCH_MAX_LENGTH = 30;
+static constexpr double BATCH_MAX_TO = 35;
+static constexpr double BATCH_MIN_EXPONENT = 2;
+static constexpr double BATCH_MAX_EXPONENT = 4;
+
+// Table files may be larger than memory, the mapping is advised in windows of
+// MAPPED_WINDOW_SIZE points and the streaming pipeline reads chunks of STREAMING_CHUNK_SIZE points
+static constexpr std::int64_t MAPPED_WINDOW_SIZE = 1 << 20;
+static constexpr std::int64_t STREAMING_CHUNK_SIZE = 1 << 22;
+
+// Same size and value range as the vectors of the mpi-dot-product sample
+static constexpr std::int64_t DOT_PRODUCT_SIZE = 1 << 23;
+static constexpr double DOT_PRODUCT_MAX_VALUE = 1000;
+
+static constexpr std::size_t TABLE_PERF_ITERATIONS_COUNT = 100;
+static constexpr std::size_t FUSED_PERF_ITERATIONS_COUNT = 2;
+
+// Quadrature rules and summations are compared by accuracy first, so their timing is sampled less
+static constexpr my::BenchmarkParams ACCURACY_PARAMS = { .warmup_count = 2, .samples_count = 20 };
+static constexpr int GAUSS_LEGENDRE_POINTS_COUNT = 5;
+static constexpr double ADAPTIVE_TOLERANCE = 1e-6;
+// Rounding errors of sin(pow(x, pi)) for x near 35 are about 1e-11, which limits the
+// tolerance the adaptive refinement can reach
+static constexpr double REFERENCE_TOLERANCE = 1e-9;
+
+my::BenchmarkResult measure_integrate(const std::function<double()>& integrate, const my::BenchmarkParams& params)
 {
-    std::cout << "| " << label << " | "
-              << std::setw(14) << std::setprecision(2) << std::fixed << result.ticks << " | "
-              << std::setw(13) << std::setprecision(2) << std::fixed << result.nanoseconds << " |" << std::endl
-              << "+-----------------------------+----------------+---------------+" << std::endl;
+    return my::run_benchmark(integrate, params);
 }
 
-std::vector<double> generate_function_values_table(arithmetic_function_t f, double from, double to, double dx)
+// Hardware counters per iteration, empty if counters are not available.
+// Events of all OpenMP threads registered in perf_events are summed up.
+// bytes_per_iteration is empty for kernels that read no table.
+std::vector<std::pair<std::string, double>> measure_perf_counters(const std::function<double()>& integrate, std::size_t iterations_count,
+                                                                  std::optional<double> bytes_per_iteration, const my::PerfEventSet& perf_events)
 {
-    std::vector<double> table;
-    table.reserve((to - from) / dx);
-    for (double x = from; x <= to; x += dx)
+    if (!perf_events.available())
     {
-        table.emplace_back(f(x));
+        return {};
+    }
+
+    my::PerfCounters counters;
+    {
+        my::PerfCounterTimer timer(perf_events, counters, iterations_count);
+        for (std::size_t i = 0; i < iterations_count; ++i)
+        {
+            double integrate_result = integrate();
+            my::do_not_optimize(integrate_result);
+        }
+    }
+    return counters.to_metrics(bytes_per_iteration);
+}
+
+// Pins every OpenMP thread according to the placement (if any) and opens hardware counters
+// for it. OpenMP runtime reuses its worker threads, so both persist across parallel regions.
+// Returns CPU each thread runs on.
+std::vector<int> setup_threads(int thread_count, const std::vector<int>& placement, my::PerfEventSet& perf_events)
+{
+    std::vector<int> thread_cpus(thread_count);
+    std::exception_ptr exception;
+    #pragma omp parallel num_threads(thread_count)
+    {
+        int thread_id = omp_get_thread_num();
+        try
+        {
+            if (!placement.empty())
+            {
+                my::topology::pin_current_thread(placement[thread_id]);
+            }
+            thread_cpus[thread_id] = my::topology::current_cpu();
+            perf_events.add_current_thread();
+        }
+        catch (...)
+        {
+            #pragma omp critical
+            exception = std::current_exception();
+        }
+    }
+    if (exception)
+    {
+        std::rethrow_exception(exception);
+    }
+    return thread_cpus;
+}
+
+// Record name centered in a column, thread count is appended to parallel variants
+std::string make_label(const my::BenchmarkRecord& record)
+{
+    std::string label = record.name;
+    if (record.name.find("parallel") != std::string::npos)
+    {
+        for (const auto& [key, value] : record.params)
+        {
+            if (key == "threads")
+            {
+                std::int64_t thread_count = std::get<std::int64_t>(value);
+                label += (thread_count < 10 ? "  " : " ") + std::to_string(thread_count);
+            }
+        }
+    }
+
+    static constexpr std::size_t LABEL_WIDTH = 27;
+    std::size_t padding = LABEL_WIDTH > label.size() ? LABEL_WIDTH - label.size() : 0;
+    return std::string(padding / 2, ' ') + label + std::string(padding - padding / 2, ' ');
+}
+
+std::optional<double> find_metric(const my::BenchmarkRecord& record, std::string_view name)
+{
+    for (const auto& [key, value] : record.metrics)
+    {
+        if (key == name)
+        {
+            return value;
+        }
+    }
+    return std::nullopt;
+}
+
+// Metric with two decimal places or n/a if the record does not have it
+std::string format_metric(const my::BenchmarkRecord& record, std::string_view name)
+{
+    std::optional<double> value = find_metric(record, name);
+    if (!value)
+    {
+        return "n/a";
+    }
+    std::ostringstream out;
+    out << std::setprecision(2) << std::fixed << *value;
+    return out.str();
+}
+
+// Human-readable layout of OutputFormat::TEXT
+class TableResultSink : public my::ResultSink
+{
+public:
+    TableResultSink()
+    {
+        std::cout << SEPARATOR << std::endl
+                  << "|           operation         |  ticks / iter  |   ns / iter   |  p99 ns/iter  | stddev ns/iter|   IPC  | B/cycle |" << std::endl
+                  << "|                             |    (median)    |   (median)    |               |               |        |         |" << std::endl
+                  << SEPARATOR << std::endl;
+    }
+
+    void write(const my::BenchmarkRecord& record) override
+    {
+        const my::BenchmarkResult& result = record.result;
+        std::cout << "| " << make_label(record) << " | "
+                  << std::setw(14) << std::setprecision(2) << std::fixed << result.ticks.median << " | "
+                  << std::setw(13) << std::setprecision(2) << std::fixed << result.nanoseconds.median << " | "
+                  << std::setw(13) << std::setprecision(2) << std::fixed << result.nanoseconds.p99 << " | "
+                  << std::setw(13) << std::setprecision(2) << std::fixed << result.nanoseconds.stddev << " | "
+                  << std::setw(6) << format_metric(record, "ipc") << " | "
+                  << std::setw(7) << format_metric(record, "bytes_per_cycle") << " |" << std::endl
+                  << SEPARATOR << std::endl;
+    }
+
+private:
+    static constexpr std::string_view SEPARATOR = "+-----------------------------+----------------+---------------+---------------+---------------+--------+---------+";
+};
+
+// Human-readable layout of OutputFormat::TEXT for worksharing schedules
+class ScheduleTableResultSink : public my::ResultSink
+{
+public:
+    ScheduleTableResultSink()
+    {
+        std::cout << std::endl
+                  << SEPARATOR << std::endl
+                  << "|           operation         |    schedule   | region ns/iter|persist ns/iter| kernel ns/iter| fork-join ns  |  barrier ns   |" << std::endl
+                  << "|                             |               |   (median)    |   (median)    |   (median)    |               |               |" << std::endl
+                  << SEPARATOR << std::endl;
+    }
+
+    void write(const my::BenchmarkRecord& record) override
+    {
+        std::string schedule = "-";
+        for (const auto& [key, value] : record.params)
+        {
+            if (key == "schedule")
+            {
+                schedule = std::get<std::string>(value);
+            }
+        }
+        std::cout << "| " << make_label(record) << " | "
+                  << std::setw(13) << schedule << " | "
+                  << std::setw(13) << format_metric(record, "region_ns") << " | "
+                  << std::setw(13) << format_metric(record, "persistent_ns") << " | "
+                  << std::setw(13) << format_metric(record, "kernel_ns") << " | "
+                  << std::setw(13) << format_metric(record, "fork_join_ns") << " | "
+                  << std::setw(13) << format_metric(record, "barrier_ns") << " |" << std::endl
+                  << SEPARATOR << std::endl;
+    }
+
+private:
+    static constexpr std::string_view SEPARATOR = "+-----------------------------+---------------+---------------+---------------+---------------+---------------+---------------+";
+};
+
+// Human-readable layout of OutputFormat::TEXT for batches of integrals
+class BatchTableResultSink : public my::ResultSink
+{
+public:
+    BatchTableResultSink()
+    {
+        std::cout << std::endl
+                  << SEPARATOR << std::endl
+                  << "|           operation         |   ns / iter   |  integrals / s  |  max abs diff |" << std::endl
+                  << "|                             |   (median)    |                 |               |" << std::endl
+                  << SEPARATOR << std::endl;
+    }
+
+    void write(const my::BenchmarkRecord& record) override
+    {
+        std::cout << "| " << make_label(record) << " | "
+                  << std::setw(13) << std::setprecision(2) << std::fixed << record.result.nanoseconds.median << " | "
+                  << std::setw(15) << std::setprecision(2) << std::fixed << find_metric(record, "integrals_per_second").value_or(0) << " | "
+                  << std::setw(13) << std::setprecision(2) << std::scientific << find_metric(record, "max_abs_difference").value_or(0) << " |" << std::endl
+                  << SEPARATOR << std::endl;
+    }
+
+private:
+    static constexpr std::string_view SEPARATOR = "+-----------------------------+---------------+-----------------+---------------+";
+};
+
+// Human-readable layout of OutputFormat::TEXT for quadrature rules
+class QuadratureTableResultSink : public my::ResultSink
+{
+public:
+    explicit QuadratureTableResultSink(double reference)
+    {
+        std::cout << std::endl
+                  << "Reference value: " << std::setprecision(17) << reference << std::endl
+                  << SEPARATOR << std::endl
+                  << "|           operation         |  evaluations  |  abs error  |   ns / iter   |" << std::endl
+                  << "|                             |               |             |   (median)    |" << std::endl
+                  << SEPARATOR << std::endl;
+    }
+
+    void write(const my::BenchmarkRecord& record) override
+    {
+        std::cout << "| " << make_label(record) << " | "
+                  << std::setw(13) << static_cast<std::int64_t>(find_metric(record, "evaluations").value_or(0)) << " | "
+                  << std::setw(11) << std::setprecision(2) << std::scientific << find_metric(record, "abs_error").value_or(0) << " | "
+                  << std::setw(13) << std::setprecision(2) << std::fixed << record.result.nanoseconds.median << " |" << std::endl
+                  << SEPARATOR << std::endl;
+    }
+
+private:
+    static constexpr std::string_view SEPARATOR = "+-----------------------------+---------------+-------------+---------------+";
+};
+
+// Human-readable layout of OutputFormat::TEXT for summation methods
+class SummationTableResultSink : public my::ResultSink
+{
+public:
+    explicit SummationTableResultSink(long double reference)
+    {
+        std::cout << std::endl
+                  << "Reference sum: " << std::setprecision(20) << reference << std::endl
+                  << SEPARATOR << std::endl
+                  << "|           operation         |          result          |  abs error  |   ns / iter   |" << std::endl
+                  << "|                             |                          |             |   (median)    |" << std::endl
+                  << SEPARATOR << std::endl;
+    }
+
+    void write(const my::BenchmarkRecord& record) override
+    {
+        std::cout << "| " << make_label(record) << " | "
+                  << std::setw(24) << std::setprecision(17) << std::defaultfloat << find_metric(record, "value").value_or(0) << " | "
+                  << std::setw(11) << std::setprecision(2) << std::scientific << find_metric(record, "abs_error").value_or(0) << " | "
+                  << std::setw(13) << std::setprecision(2) << std::fixed << record.result.nanoseconds.median << " |" << std::endl
+                  << SEPARATOR << std::endl;
+    }
+
+private:
+    static constexpr std::string_view SEPARATOR = "+-----------------------------+--------------------------+-------------+---------------+";
+};
+
+my::BenchmarkRecord make_record(std::string name, const Domain& domain, int thread_count, my::BenchmarkResult result,
+                                std::vector<std::pair<std::string, double>> metrics, std::string_view precision = "double")
+{
+    return { .name = std::move(name),
+             .params = { { "size", domain.points_count },
+                         { "dx", domain.dx },
+                         { "threads", std::int64_t{ thread_count } },
+                         { "precision", std::string(precision) } },
+             .result = result,
+             .metrics = std::move(metrics) };
+}
+
+function_values_table_t generate_function_values_table(arithmetic_function_t f, const Domain& domain)
+{
+    function_values_table_t table;
+    table.reserve(domain.points_count);
+    for (std::int64_t i = 0; i < domain.points_count; ++i)
+    {
+        table.emplace_back(f(domain.point(i)));
+    }
+    return table;
+}
+
+function_values_table_t generate_function_values_table_simd(const Domain& domain)
+{
+    function_values_table_t table(domain.points_count);
+    my::simd_math::evaluate_points(simd_arithmetic_function, domain.from, domain.dx, 0, domain.points_count, table.data());
+    return table;
+}
+
+// Every thread fills the block of the table it reads in integrate_omp_parallel with
+// the same thread count, so that the pages are allocated on its NUMA node.
+// Narrower storage is filled through a buffer of double values.
+template <typename Storage = double>
+values_table_t<Storage> generate_function_values_table_first_touch(const Domain& domain, int thread_count)
+{
+    using Traits = my::precision::StorageTraits<Storage>;
+    static constexpr std::int64_t BUFFER_SIZE = 1024;
+
+    values_table_t<Storage> table(domain.points_count);
+    omp_set_num_threads(thread_count);
+    #pragma omp parallel
+    {
+        auto [first, last] = my::quadrature::static_block(domain.points_count, omp_get_thread_num(), omp_get_num_threads());
+        if constexpr (std::is_same_v<Storage, double>)
+        {
+            my::simd_math::evaluate_points(simd_arithmetic_function, domain.from, domain.dx, first, last - first, table.data() + first);
+        }
+        else
+        {
+            double buffer[BUFFER_SIZE];
+            for (std::int64_t block_first = first; block_first < last; block_first += BUFFER_SIZE)
+            {
+                std::int64_t block_size = std::min(BUFFER_SIZE, last - block_first);
+                my::simd_math::evaluate_points(simd_arithmetic_function, domain.from, domain.dx, block_first, block_size, buffer);
+                for (std::int64_t i = 0; i < block_size; ++i)
+                {
+                    table[block_first + i] = Traits::store(buffer[i]);
+                }
+            }
+        }
     }
     return table;
 }
 
+// Table generation with libm through std::function and with SIMD kernels
+void benchmark_generation(const Domain& domain, int max_thread_count, const my::PerfEventSet& perf_events, my::ResultSink& sink)
+{
+    double table_bytes = static_cast<double>(domain.points_count * sizeof(double));
+
+    auto benchmark = [&](std::string name, int thread_count, const std::function<double()>& generate)
+    {
+        sink.write(make_record(std::move(name), domain, thread_count,
+                               measure_integrate(generate, FUSED_PARAMS),
+                               measure_perf_counters(generate, FUSED_PERF_ITERATIONS_COUNT, table_bytes, perf_events)));
+    };
+
+    benchmark("generate table", 1, [&domain]() { return generate_function_values_table(arithmetic_function, domain).back(); });
+    benchmark("generate table simd", 1, [&domain]() { return generate_function_values_table_simd(domain).back(); });
+    for (int thread_count = 1; thread_count <= max_thread_count; ++thread_count)
+    {
+        benchmark("generate parallel", thread_count, [&domain, thread_count]()
+                  {
+                      return generate_function_values_table_first_touch(domain, thread_count).back();
+                  });
+    }
+}
+
+// Benchmarks table-based integration with every thread count up to max_thread_count,
+// explicit vector kernels are measured for every instruction set supported by the CPU.
+// "integrate omp parallel" reads a table filled by the master thread, so on multi-socket
+// hosts all its pages reside on one NUMA node; "first touch parallel" reads a table filled
+// by the same threads with the same partition.
+void benchmark_table(const Domain& domain, int max_thread_count, const my::PerfEventSet& perf_events, my::ResultSink& sink)
+{
+    function_values_table_t table = generate_function_values_table_simd(domain);
+    double table_bytes = static_cast<double>(table.size() * sizeof(double));
+
+    auto benchmark = [&](std::string name, int thread_count, const std::function<double()>& integrate)
+    {
+        sink.write(make_record(std::move(name), domain, thread_count,
+                               measure_integrate(integrate, TABLE_PARAMS),
+                               measure_perf_counters(integrate, TABLE_PERF_ITERATIONS_COUNT, table_bytes, perf_events)));
+    };
+
+    benchmark("integrate dummy", 1, [&table, &domain]() { return integrate_dummy(table, domain.dx); });
+    benchmark("integrate omp simd", 1, [&table, &domain]() { return integrate_omp_simd(table, domain.dx); });
+    for (my::kernels::Isa isa : my::kernels::supported_isas())
+    {
+        my::kernels::integrate_kernel_t kernel = my::kernels::integrate_kernel(isa);
+        benchmark("kernel " + std::string(my::kernels::to_string(isa)), 1, [&table, &domain, kernel]()
+                  {
+                      return kernel(table.data(), static_cast<std::int64_t>(table.size()), domain.dx);
+                  });
+    }
+    for (int thread_count = 1; thread_count <= max_thread_count; ++thread_count)
+    {
+        benchmark("integrate omp parallel", thread_count, [&table, &domain, thread_count]()
+                  {
+                      return integrate_omp_parallel(table, domain.dx, thread_count);
+                  });
+    }
+    for (int thread_count = 1; thread_count <= max_thread_count; ++thread_count)
+    {
+        benchmark("kernel parallel", thread_count, [&table, &domain, thread_count]()
+                  {
+                      return integrate_kernel_parallel(table, domain.dx, thread_count);
+                  });
+    }
+    if constexpr (my::backends::TBB_AVAILABLE)
+    {
+        for (int thread_count = 1; thread_count <= max_thread_count; ++thread_count)
+        {
+            benchmark("std execution parallel", thread_count, [&table, &domain, thread_count]()
+                      {
+                          return my::backends::integrate_std_parallel(table.data(), static_cast<std::int64_t>(table.size()), domain.dx, thread_count);
+                      });
+        }
+        for (int thread_count = 1; thread_count <= max_thread_count; ++thread_count)
+        {
+            benchmark("tbb parallel", thread_count, [&table, &domain, thread_count]()
+                      {
+                          return my::backends::integrate_tbb_parallel(table.data(), static_cast<std::int64_t>(table.size()), domain.dx, thread_count);
+                      });
+        }
+    }
+
+    // Releases the table filled by the master thread
+    function_values_table_t().swap(table);
+    for (int thread_count = 1; thread_count <= max_thread_count; ++thread_count)
+    {
+        function_values_table_t local_table = generate_function_values_table_first_touch(domain, thread_count);
+        benchmark("first touch parallel", thread_count, [&local_table, &domain, thread_count]()
+                  {
+                      return integrate_omp_parallel(local_table, domain.dx, thread_count);
+                  });
+    }
+}
+
+// Integration of a table file written by openmp-write-table, which is read through a mapping
+// or with the double-buffered pipeline. Unless the file is larger than memory, it stays in the
+// page cache after the warmup, so the sample measures page cache rather than disk bandwidth.
+void benchmark_table_file(const std::string& path, int max_thread_count, const my::PerfEventSet& perf_events, my::ResultSink& sink)
+{
+    const my::table_file::MappedTable table(path);
+    const Domain domain{ .from = table.header().from, .dx = table.header().dx, .points_count = table.size() };
+    double table_bytes = static_cast<double>(table.size() * sizeof(double));
+
+    auto benchmark = [&](std::string name, int thread_count, const std::function<double()>& integrate)
+    {
+        my::BenchmarkResult result = measure_integrate(integrate, FUSED_PARAMS);
+        std::vector<std::pair<std::string, double>> metrics = measure_perf_counters(integrate, FUSED_PERF_ITERATIONS_COUNT, table_bytes, perf_events);
+        metrics.emplace_back("gigabytes_per_second", table_bytes / result.nanoseconds.median);
+        sink.write(make_record(std::move(name), domain, thread_count, result, std::move(metrics)));
+    };
+
+    for (int thread_count = 1; thread_count <= max_thread_count; ++thread_count)
+    {
+        benchmark("mapped parallel", thread_count, [&table, thread_count]()
+                  {
+                      return my::table_file::integrate_mapped_parallel(table, MAPPED_WINDOW_SIZE, thread_count);
+                  });
+    }
+    for (int thread_count = 1; thread_count <= max_thread_count; ++thread_count)
+    {
+        benchmark("streaming parallel", thread_count, [&path, thread_count]()
+                  {
+                      return my::table_file::integrate_streaming_parallel(path, STREAMING_CHUNK_SIZE, thread_count);
+                  });
+    }
+}
+
+// The dot product of the cuda-dot-product and mpi-dot-product samples on one host with OpenMP,
+// C++17 parallel algorithms and oneTBB, the latter two are measured only if oneTBB is found
+void benchmark_dot_product(int max_thread_count, const my::PerfEventSet& perf_events, my::ResultSink& sink)
+{
+    std::mt19937 generator(0);
+    std::uniform_real_distribution<double> distribution(-DOT_PRODUCT_MAX_VALUE, DOT_PRODUCT_MAX_VALUE);
+    function_values_table_t a(DOT_PRODUCT_SIZE);
+    function_values_table_t b(DOT_PRODUCT_SIZE);
+    for (std::int64_t i = 0; i < DOT_PRODUCT_SIZE; ++i)
+    {
+        a[i] = distribution(generator);
+        b[i] = distribution(generator);
+    }
+    double vectors_bytes = static_cast<double>(2 * DOT_PRODUCT_SIZE * sizeof(double));
+
+    auto benchmark = [&](std::string name, int thread_count, const std::function<double()>& dot_product)
+    {
+        sink.write({ .name = std::move(name),
+                     .params = { { "size", DOT_PRODUCT_SIZE },
+                                 { "threads", std::int64_t{ thread_count } },
+                                 { "precision", std::string("double") } },
+                     .result = measure_integrate(dot_product, FUSED_PARAMS),
+                     .metrics = measure_perf_counters(dot_product, FUSED_PERF_ITERATIONS_COUNT, vectors_bytes, perf_events) });
+    };
+
+    benchmark("dot product regular", 1, [&a, &b]() { return my::backends::dot_product_regular(a.data(), b.data(), DOT_PRODUCT_SIZE); });
+    for (int thread_count = 1; thread_count <= max_thread_count; ++thread_count)
+    {
+        benchmark("dot product omp parallel", thread_count, [&a, &b, thread_count]()
+                  {
+                      return my::backends::dot_product_omp_parallel(a.data(), b.data(), DOT_PRODUCT_SIZE, thread_count);
+                  });
+    }
+    if constexpr (my::backends::TBB_AVAILABLE)
+    {
+        for (int thread_count = 1; thread_count <= max_thread_count; ++thread_count)
+        {
+            benchmark("dot product std parallel", thread_count, [&a, &b, thread_count]()
+                      {
+                          return my::backends::dot_product_std_parallel(a.data(), b.data(), DOT_PRODUCT_SIZE, thread_count);
+                      });
+        }
+        for (int thread_count = 1; thread_count <= max_thread_count; ++thread_count)
+        {
+            benchmark("dot product tbb parallel", thread_count, [&a, &b, thread_count]()
+                      {
+                          return my::backends::dot_product_tbb_parallel(a.data(), b.data(), DOT_PRODUCT_SIZE, thread_count);
+                      });
+        }
+    }
+}
+
+// Same as benchmark_table, but the function is evaluated on the fly
+void benchmark_fused(const Domain& domain, int max_thread_count, const my::PerfEventSet& perf_events, my::ResultSink& sink)
+{
+    auto benchmark = [&](std::string name, int thread_count, const std::function<double()>& integrate)
+    {
+        sink.write(make_record(std::move(name), domain, thread_count,
+                               measure_integrate(integrate, FUSED_PARAMS),
+                               measure_perf_counters(integrate, FUSED_PERF_ITERATIONS_COUNT, std::nullopt, perf_events)));
+    };
+
+    benchmark("fused dummy", 1, [&domain]() { return integrate_fused_dummy(domain); });
+    benchmark("fused omp simd", 1, [&domain]() { return integrate_fused_omp_simd(domain); });
+    for (int thread_count = 1; thread_count <= max_thread_count; ++thread_count)
+    {
+        benchmark("fused omp parallel", thread_count, [&domain, thread_count]()
+                  {
+                      return integrate_fused_omp_parallel(domain, thread_count);
+                  });
+    }
+    benchmark("fused simd", 1, [&domain]() { return integrate_fused_simd(domain); });
+    for (int thread_count = 1; thread_count <= max_thread_count; ++thread_count)
+    {
+        benchmark("fused simd parallel", thread_count, [&domain, thread_count]()
+                  {
+                      return integrate_fused_simd_parallel(domain, thread_count);
+                  });
+    }
+}
+
+// Splits the time of a parallel worksharing loop into the time threads spend in their chunks
+// ("kernel_ns"), the barrier at its end, including load imbalance ("barrier_ns"), and the fork
+// and join of a parallel region for every iteration ("fork_join_ns"), which a persistent region
+// avoids. Fork and join time is the difference of medians of two measurements, so it is only
+// an estimate. "empty region parallel" is the cost of a parallel region without any work.
+void benchmark_schedules(const Domain& domain, int max_thread_count, my::ResultSink& sink)
+{
+    function_values_table_t table = generate_function_values_table_first_touch(domain, max_thread_count);
+
+    for (int thread_count = 1; thread_count <= max_thread_count; ++thread_count)
+    {
+        my::BenchmarkResult empty = measure_integrate([thread_count]()
+                                                      {
+                                                          empty_parallel_region(thread_count);
+                                                          return 0.0;
+                                                      },
+                                                      SCHEDULE_PARAMS);
+        sink.write(make_record("empty region parallel", domain, thread_count, empty, { { "region_ns", empty.nanoseconds.median } }));
+
+        for (const Schedule& schedule : SCHEDULES)
+        {
+            omp_set_schedule(schedule.kind, schedule.chunk_size);
+            double region_ns = measure_integrate([&table, &domain, thread_count]()
+                                                 {
+                                                     return integrate_omp_parallel_runtime(table, domain.dx, thread_count);
+                                                 },
+                                                 SCHEDULE_PARAMS).nanoseconds.median;
+            PersistentRegionResult persistent = measure_persistent_region(table, domain.dx, thread_count, SCHEDULE_PARAMS);
+            double persistent_ns = persistent.iteration.nanoseconds.median;
+
+            my::BenchmarkRecord record = make_record("persistent parallel", domain, thread_count, persistent.iteration,
+                                                     { { "region_ns", region_ns },
+                                                       { "persistent_ns", persistent_ns },
+                                                       { "kernel_ns", persistent.kernel.nanoseconds.median },
+                                                       { "fork_join_ns", region_ns - persistent_ns },
+                                                       { "barrier_ns", persistent.barrier.nanoseconds.median } });
+            record.params.emplace_back("schedule", to_string(schedule));
+            sink.write(record);
+        }
+    }
+    // Restores the default schedule
+    omp_set_schedule(omp_sched_static, 0);
+}
+
+my::batch::Jobs make_batch_jobs(std::size_t jobs_count)
+{
+    // Fixed seed, so that every run integrates the same jobs
+    std::mt19937_64 generator(jobs_count);
+    std::uniform_real_distribution<double> length_distribution(BATCH_MIN_LENGTH, BATCH_MAX_LENGTH);
+    std::uniform_real_distribution<double> exponent_distribution(BATCH_MIN_EXPONENT, BATCH_MAX_EXPONENT);
+
+    my::batch::Jobs jobs;
+    for (std::size_t i = 0; i < jobs_count; ++i)
+    {
+        double length = length_distribution(generator);
+        double from = std::uniform_real_distribution<double>(0, BATCH_MAX_TO - length)(generator);
+        jobs.from.push_back(from);
+        jobs.to.push_back(from + length);
+        jobs.parameters.push_back(exponent_distribution(generator));
+    }
+    return jobs;
+}
+
+// Compares vectorization across jobs with vectorization within every job. Results are
+// compared with the ones of the latter with one thread.
+void benchmark_batch(int max_thread_count, my::ResultSink& sink)
+{
+    const my::batch::Jobs jobs = make_batch_jobs(BATCH_JOBS_COUNT);
+    std::vector<double> reference(jobs.size());
+    my::batch::integrate_per_job_parallel(simd_parametrized_function, jobs, BATCH_DX, reference.data(), 1);
+    std::vector<double> results(jobs.size());
+
+    auto benchmark = [&](std::string name, int thread_count, const std::function<double()>& integrate)
+    {
+        integrate();
+        double max_difference = 0;
+        for (std::size_t i = 0; i < jobs.size(); ++i)
+        {
+            max_difference = std::max(max_difference, std::fabs(results[i] - reference[i]));
+        }
+        my::BenchmarkResult result = measure_integrate(integrate, FUSED_PARAMS);
+        double integrals_per_second = static_cast<double>(jobs.size()) / result.nanoseconds.median * 1e9;
+        sink.write({ .name = std::move(name),
+                     .params = { { "jobs", static_cast<std::int64_t>(jobs.size()) },
+                                 { "dx", BATCH_DX },
+                                 { "threads", std::int64_t{ thread_count } },
+                                 { "precision", "double" } },
+                     .result = result,
+                     .metrics = { { "integrals_per_second", integrals_per_second }, { "max_abs_difference", max_difference } } });
+    };
+
+    for (int thread_count = 1; thread_count <= max_thread_count; ++thread_count)
+    {
+        benchmark("batch per job parallel", thread_count, [&jobs, &results, thread_count]()
+                  {
+                      my::batch::integrate_per_job_parallel(simd_parametrized_function, jobs, BATCH_DX, results.data(), thread_count);
+                      return results.front();
+                  });
+    }
+    for (int thread_count = 1; thread_count <= max_thread_count; ++thread_count)
+    {
+        benchmark("batch simd parallel", thread_count, [&jobs, &results, thread_count]()
+                  {
+                      my::batch::integrate_simd_parallel(simd_parametrized_function, jobs, BATCH_DX, results.data(), thread_count);
+                      return results.front();
+                  });
+    }
+}
+
+// Compares rules of higher order with the rectangle sum on the same table (or the same
+// number of evaluations for Gauss-Legendre), adaptive Gauss-Kronrod evaluates the function
+// only where it is needed to reach ADAPTIVE_TOLERANCE
+void benchmark_quadrature(const Domain& domain, double reference, int max_thread_count, my::ResultSink& sink)
+{
+    function_values_table_t table = generate_function_values_table_first_touch(domain, max_thread_count);
+    const double* values = table.data();
+    const std::int64_t count = domain.points_count;
+    const double to = domain.point(count - 1);
+
+    auto benchmark = [&](std::string name, int thread_count, std::int64_t evaluations, const std::function<double()>& integrate)
+    {
+        double error = std::fabs(integrate() - reference);
+        sink.write(make_record(std::move(name), domain, thread_count,
+                               measure_integrate(integrate, ACCURACY_PARAMS),
+                               { { "evaluations", static_cast<double>(evaluations) }, { "abs_error", error } }));
+    };
+
+    const my::quadrature::Rule rule = my::quadrature::gauss_legendre_rule(GAUSS_LEGENDRE_POINTS_COUNT);
+    const std::int64_t segments_count = count / GAUSS_LEGENDRE_POINTS_COUNT;
+    const std::int64_t gauss_legendre_evaluations = segments_count * GAUSS_LEGENDRE_POINTS_COUNT;
+
+    benchmark("rectangle simd", 1, count, [&table, &domain]() { return integrate_omp_simd(table, domain.dx); });
+    benchmark("trapezoid simd", 1, count, [values, count, &domain]()
+              {
+                  return my::quadrature::trapezoid_simd(values, count, domain.dx);
+              });
+    benchmark("simpson simd", 1, count, [values, count, &domain]()
+              {
+                  return my::quadrature::simpson_simd(values, count, domain.dx);
+              });
+    benchmark("gauss-legendre simd", 1, gauss_legendre_evaluations, [&rule, &domain, to, segments_count]()
+              {
+                  return my::quadrature::gauss_legendre_simd(simd_arithmetic_function, rule, domain.from, to, segments_count);
+              });
+
+    for (int thread_count = 1; thread_count <= max_thread_count; ++thread_count)
+    {
+        benchmark("trapezoid parallel", thread_count, count, [values, count, &domain, thread_count]()
+                  {
+                      return my::quadrature::trapezoid_parallel(values, count, domain.dx, thread_count);
+                  });
+    }
+    for (int thread_count = 1; thread_count <= max_thread_count; ++thread_count)
+    {
+        benchmark("simpson parallel", thread_count, count, [values, count, &domain, thread_count]()
+                  {
+                      return my::quadrature::simpson_parallel(values, count, domain.dx, thread_count);
+                  });
+    }
+    for (int thread_count = 1; thread_count <= max_thread_count; ++thread_count)
+    {
+        benchmark("gauss-legendre parallel", thread_count, gauss_legendre_evaluations, [&rule, &domain, to, segments_count, thread_count]()
+                  {
+                      return my::quadrature::gauss_legendre_parallel(simd_arithmetic_function, rule, domain.from, to, segments_count, thread_count);
+                  });
+    }
+    for (int thread_count = 1; thread_count <= max_thread_count; ++thread_count)
+    {
+        auto integrate = [&domain, to, thread_count]()
+        {
+            return my::quadrature::gauss_kronrod_adaptive(simd_arithmetic_function, domain.from, to, ADAPTIVE_TOLERANCE, thread_count);
+        };
+        std::int64_t evaluations = integrate().evaluations;
+        benchmark("gauss-kronrod parallel", thread_count, evaluations, [&integrate]() { return integrate().value; });
+    }
+}
+
+// Sum of dx * f(x_i) in extended precision with Neumaier summation, its relative
+// error is about 2^-64, which is far below the errors of double summations
+long double reference_sum(const function_values_table_t& table, double dx)
+{
+    long double sum = 0;
+    long double compensation = 0;
+    for (double value : table)
+    {
+        long double term = static_cast<long double>(value);
+        long double new_sum = sum + term;
+        compensation += (std::fabs(sum) >= std::fabs(term) ? (sum - new_sum) + term : (term - new_sum) + sum);
+        sum = new_sum;
+    }
+    return dx * (sum + compensation);
+}
+
+// Writes the result of integrate, its error and its run time
+void benchmark_sum(std::string name, const Domain& domain, int thread_count, std::string_view precision, long double reference,
+                   const std::function<double()>& integrate, my::ResultSink& sink)
+{
+    double value = integrate();
+    double error = static_cast<double>(std::fabs(static_cast<long double>(value) - reference));
+    sink.write(make_record(std::move(name), domain, thread_count,
+                           measure_integrate(integrate, ACCURACY_PARAMS),
+                           { { "value", value }, { "abs_error", error } }, precision));
+}
+
+// Plain reduction gives a different result for every thread count, compensated and pairwise
+// reductions are more accurate but still depend on it, the reproducible one does not
+void benchmark_summation(const Domain& domain, const function_values_table_t& table, long double reference, int max_thread_count,
+                         my::ResultSink& sink)
+{
+    auto benchmark = [&](std::string name, int thread_count, const std::function<double()>& integrate)
+    {
+        benchmark_sum(std::move(name), domain, thread_count, "double", reference, integrate, sink);
+    };
+
+    auto sweep = [&](const std::string& name, double (*integrate)(const function_values_table_t&, double, int))
+    {
+        for (int thread_count = 1; thread_count <= max_thread_count; ++thread_count)
+        {
+            benchmark(name, thread_count, [&table, &domain, integrate, thread_count]()
+                      {
+                          return integrate(table, domain.dx, thread_count);
+                      });
+        }
+    };
+
+    benchmark("plain simd", 1, [&table, &domain]() { return integrate_omp_simd(table, domain.dx); });
+    sweep("plain parallel", integrate_omp_parallel);
+    sweep("kahan parallel", integrate_kahan_parallel);
+    sweep("neumaier parallel", integrate_neumaier_parallel);
+    sweep("pairwise parallel", integrate_pairwise_parallel);
+    sweep("reproducible parallel", integrate_reproducible_parallel);
+}
+
+// Narrower storage of the same table, errors are compared with the exact sum of the double one
+template <typename Storage>
+void benchmark_storage(const Domain& domain, long double reference, int max_thread_count, my::ResultSink& sink)
+{
+    static constexpr std::string_view NAME = my::precision::StorageTraits<Storage>::NAME;
+    values_table_t<Storage> table = generate_function_values_table_first_touch<Storage>(domain, max_thread_count);
+
+    benchmark_sum(std::string(NAME) + " simd", domain, 1, NAME, reference, [&table, &domain]()
+                  {
+                      return integrate_omp_simd(table, domain.dx);
+                  },
+                  sink);
+    for (int thread_count = 1; thread_count <= max_thread_count; ++thread_count)
+    {
+        benchmark_sum(std::string(NAME) + " parallel", domain, thread_count, NAME, reference, [&table, &domain, thread_count]()
+                      {
+                          return integrate_omp_parallel(table, domain.dx, thread_count);
+                      },
+                      sink);
+    }
+}
+
 }  // namespace
 
-int main() try
+int main(int argc, char* argv[]) try
 {
-    double dx = 0.00001;
-    function_values_table_t table = generate_function_values_table(arithmetic_function, -43.54325, 34.6354, dx);
+    my::OutputFormat format = my::output_format_from_cmd_line(argc, argv);
+    my::topology::Pinning pinning = my::topology::pinning_from_string(my::find_cmd_line_option(argc, argv, "pin").value_or("none"));
 
-    my::TicksAndNanoseconds integrate_dummy_result = measure_integrate(integrate_dummy, table, dx);
-    my::TicksAndNanoseconds integrate_omp_simd_result = measure_integrate(integrate_omp_simd, table, dx);
+    const Domain domain = make_domain(-43.54325, 34.6354, 0.00001);
 
     int max_thread_count = omp_get_max_threads();
     if (max_thread_count <= 0)
     {
         throw std::runtime_error("omp_get_max_threads returned " + std::to_string(max_thread_count));
     }
+    // Thread teams must consist of the threads pinned below
+    omp_set_dynamic(0);
 
-    std::vector<my::TicksAndNanoseconds> integrate_omp_parallel_results(max_thread_count);
-    for (int thread_count = 1; thread_count <= max_thread_count; ++thread_count)
+    my::topology::Topology topology = my::topology::Topology::detect();
+    my::PerfEventSet perf_events;
+    std::vector<int> thread_cpus = setup_threads(max_thread_count,
+                                                 my::topology::make_placement(topology, pinning, max_thread_count),
+                                                 perf_events);
+
+    std::ostream& header = my::header_stream(format);
+    header << "Topology: " << topology.describe() << std::endl
+           << "Pinning: " << my::topology::to_string(pinning.policy) << std::endl
+           << "Placement:";
+    for (int thread_id = 0; thread_id < max_thread_count; ++thread_id)
     {
-        using namespace std::placeholders;
-        integrate_omp_parallel_results[thread_count - 1] = measure_integrate(std::bind(integrate_omp_parallel, _1, _2, thread_count), table, dx);
+        header << (thread_id % 8 == 0 ? "\n   " : "") << " thread " << thread_id << " -> cpu " << thread_cpus[thread_id] << ";";
     }
+    header << std::endl;
 
-    std::cout << "+-----------------------------+----------------+---------------+" << std::endl
-              << "|           operation         |  ticks / iter  |   ns / iter   |" << std::endl
-              << "+-----------------------------+----------------+---------------+" << std::endl;
+    std::unique_ptr<my::ResultSink> sink = (format == my::OutputFormat::TEXT ? std::make_unique<TableResultSink>()
+                                                                           : my::make_result_sink(format, "openmp"));
 
-    print_table_row("      integrate dummy      ", integrate_dummy_result);
-    print_table_row("     integrate omp simd    ", integrate_omp_simd_result);
+    benchmark_generation(domain, max_thread_count, perf_events, *sink);
+    benchmark_table(domain, max_thread_count, perf_events, *sink);
+    if (std::optional<std::string_view> table_path = my::find_cmd_line_option(argc, argv, "table"))
+    {
+        benchmark_table_file(std::string(*table_path), max_thread_count, perf_events, *sink);
+    }
+    benchmark_dot_product(max_thread_count, perf_events, *sink);
+    benchmark_fused(domain, max_thread_count, perf_events, *sink);
 
-    for (int thread_count = 1; thread_count <= max_thread_count; ++thread_count)
+    if (format == my::OutputFormat::TEXT)
+    {
+        sink = std::make_unique<ScheduleTableResultSink>();
+    }
+    benchmark_schedules(domain, max_thread_count, *sink);
+
+    if (format == my::OutputFormat::TEXT)
     {
-        print_table_row(std::string(" integrate omp parallel ") + (thread_count < 10 ? " " : "") + std::to_string(thread_count) + " ",
-                        integrate_omp_parallel_results[thread_count - 1]);
+        sink = std::make_unique<BatchTableResultSink>();
     }
+    benchmark_batch(max_thread_count, *sink);
+
+    // The integrand is NaN for negative x, so accuracy is compared on the positive part of the domain
+    const Domain quadrature_domain = make_domain(0, 34.6354, 0.00001);
+    double reference = my::quadrature::gauss_kronrod_adaptive(arithmetic_function, quadrature_domain.from,
+                                                              quadrature_domain.point(quadrature_domain.points_count - 1),
+                                                              REFERENCE_TOLERANCE, max_thread_count).value;
+    if (format == my::OutputFormat::TEXT)
+    {
+        sink = std::make_unique<QuadratureTableResultSink>(reference);
+    }
+    benchmark_quadrature(quadrature_domain, reference, max_thread_count, *sink);
+
+    function_values_table_t table = generate_function_values_table_first_touch(quadrature_domain, max_thread_count);
+    long double table_reference = reference_sum(table, quadrature_domain.dx);
+    if (format == my::OutputFormat::TEXT)
+    {
+        sink = std::make_unique<SummationTableResultSink>(table_reference);
+    }
+    benchmark_summation(quadrature_domain, table, table_reference, max_thread_count, *sink);
+
+    benchmark_storage<float>(quadrature_domain, table_reference, max_thread_count, *sink);
+    benchmark_storage<my::precision::Half>(quadrature_domain, table_reference, max_thread_count, *sink);
+    benchmark_storage<my::precision::BFloat16>(quadrature_domain, table_reference, max_thread_count, *sink);
 
     return EXIT_SUCCESS;
 }
@@ -0,0 +1,141 @@
+#include <parallel_backends.hpp>
+
+#include <omp.h>
+
+#include <stdexcept>
+
+#if defined(PC_HAS_TBB)
+#include <oneapi/tbb/blocked_range.h>
+#include <oneapi/tbb/parallel_reduce.h>
+#include <oneapi/tbb/task_arena.h>
+
+#include <execution>
+#include <functional>
+#include <numeric>
+#endif
+
+namespace my::backends
+{
+
+namespace
+{
+
+#if defined(PC_HAS_TBB)
+// Iterations of a TBB task are vectorized, so they should not be too few
+static constexpr std::int64_t TBB_GRAIN_SIZE = 1 << 14;
+
+template <typename Function>
+double run_in_arena(int thread_count, Function function)
+{
+    oneapi::tbb::task_arena arena(thread_count);
+    return arena.execute(function);
+}
+#else
+[[noreturn]] void throw_unavailable()
+{
+    throw std::logic_error("The sample is built without oneTBB");
+}
+#endif
+
+}  // namespace
+
+double integrate_std_parallel(const double* values, std::int64_t count, double dx, int thread_count)
+{
+#if defined(PC_HAS_TBB)
+    return run_in_arena(thread_count, [values, count, dx]()
+                        {
+                            return dx * std::reduce(std::execution::par_unseq, values, values + count, 0.0);
+                        });
+#else
+    static_cast<void>(values), static_cast<void>(count), static_cast<void>(dx), static_cast<void>(thread_count);
+    throw_unavailable();
+#endif
+}
+
+double integrate_tbb_parallel(const double* values, std::int64_t count, double dx, int thread_count)
+{
+#if defined(PC_HAS_TBB)
+    return run_in_arena(thread_count, [values, count, dx]()
+                        {
+                            using range_t = oneapi::tbb::blocked_range<std::int64_t>;
+                            double sum = oneapi::tbb::parallel_reduce(
+                                range_t(0, count, TBB_GRAIN_SIZE), 0.0,
+                                [values](const range_t& range, double partial_sum)
+                                {
+                                    #pragma omp simd reduction(+ : partial_sum)
+                                    for (std::int64_t i = range.begin(); i < range.end(); ++i)
+                                    {
+                                        partial_sum += values[i];
+                                    }
+                                    return partial_sum;
+                                },
+                                std::plus<>());
+                            return dx * sum;
+                        });
+#else
+    static_cast<void>(values), static_cast<void>(count), static_cast<void>(dx), static_cast<void>(thread_count);
+    throw_unavailable();
+#endif
+}
+
+double dot_product_regular(const double* a, const double* b, std::int64_t size)
+{
+    double dot_product = 0;
+    for (std::int64_t i = 0; i < size; ++i)
+    {
+        dot_product += a[i] * b[i];
+    }
+    return dot_product;
+}
+
+double dot_product_omp_parallel(const double* a, const double* b, std::int64_t size, int thread_count)
+{
+    double dot_product = 0;
+    omp_set_num_threads(thread_count);
+    #pragma omp parallel for simd schedule(static) reduction(+ : dot_product)
+    for (std::int64_t i = 0; i < size; ++i)
+    {
+        dot_product += a[i] * b[i];
+    }
+    return dot_product;
+}
+
+double dot_product_std_parallel(const double* a, const double* b, std::int64_t size, int thread_count)
+{
+#if defined(PC_HAS_TBB)
+    return run_in_arena(thread_count, [a, b, size]()
+                        {
+                            return std::transform_reduce(std::execution::par_unseq, a, a + size, b, 0.0);
+                        });
+#else
+    static_cast<void>(a), static_cast<void>(b), static_cast<void>(size), static_cast<void>(thread_count);
+    throw_unavailable();
+#endif
+}
+
+double dot_product_tbb_parallel(const double* a, const double* b, std::int64_t size, int thread_count)
+{
+#if defined(PC_HAS_TBB)
+    return run_in_arena(thread_count, [a, b, size]()
+                        {
+                            using range_t = oneapi::tbb::blocked_range<std::int64_t>;
+                            return oneapi::tbb::parallel_reduce(
+                                range_t(0, size, TBB_GRAIN_SIZE), 0.0,
+                                [a, b](const range_t& range, double partial_sum)
+                                {
+                                    #pragma omp simd reduction(+ : partial_sum)
+                                    for (std::int64_t i = range.begin(); i < range.end(); ++i)
+                                    {
+                                        partial_sum += a[i] * b[i];
+                                    }
+                                    return partial_sum;
+                                },
+                                std::plus<>());
+                        });
+#else
+    static_cast<void>(a), static_cast<void>(b), static_cast<void>(size), static_cast<void>(thread_count);
+    throw_unavailable();
+#endif
+}
+
+}  // namespace my::backends
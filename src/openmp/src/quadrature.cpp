@@ -0,0 +1,150 @@
+#include <quadrature.hpp>
+
+#include <omp.h>
+
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+namespace my::quadrature
+{
+
+namespace
+{
+
+// Sum of values[i] over [first, last) with weights 4 for odd and 2 for even i
+double simpson_inner_sum_simd(const double* values, std::int64_t first, std::int64_t last)
+{
+    double sum = 0;
+    #pragma omp simd reduction(+ : sum)
+    for (std::int64_t i = first; i < last; ++i)
+    {
+        sum += (i % 2 == 1 ? 4.0 : 2.0) * values[i];
+    }
+    return sum;
+}
+
+double simpson_inner_sum_parallel(const double* values, std::int64_t first, std::int64_t last, int thread_count)
+{
+    double sum = 0;
+    omp_set_num_threads(thread_count);
+    #pragma omp parallel for simd schedule(static) reduction(+ : sum)
+    for (std::int64_t i = first; i < last; ++i)
+    {
+        sum += (i % 2 == 1 ? 4.0 : 2.0) * values[i];
+    }
+    return sum;
+}
+
+template <typename InnerSum>
+double simpson(const double* values, std::int64_t count, double dx, InnerSum inner_sum)
+{
+    std::int64_t segments_count = count - 1;
+    if (segments_count < 2)
+    {
+        return count < 2 ? 0 : dx * (values[0] + values[1]) / 2;
+    }
+
+    // Simpson rule on [0, last], 3/8 rule on the remaining three segments if any
+    std::int64_t last = (segments_count % 2 == 0 ? segments_count : segments_count - 3);
+    double result = 0;
+    if (last > 0)
+    {
+        result = dx / 3 * (values[0] + inner_sum(values, 1, last) + values[last]);
+    }
+    if (last != segments_count)
+    {
+        result += 3 * dx / 8 * (values[last] + 3 * values[last + 1] + 3 * values[last + 2] + values[last + 3]);
+    }
+    return result;
+}
+
+}  // namespace
+
+double trapezoid_simd(const double* values, std::int64_t count, double dx)
+{
+    if (count < 2)
+    {
+        return 0;
+    }
+    double sum = 0;
+    #pragma omp simd reduction(+ : sum)
+    for (std::int64_t i = 1; i < count - 1; ++i)
+    {
+        sum += values[i];
+    }
+    return dx * (sum + (values[0] + values[count - 1]) / 2);
+}
+
+double trapezoid_parallel(const double* values, std::int64_t count, double dx, int thread_count)
+{
+    if (count < 2)
+    {
+        return 0;
+    }
+    double sum = 0;
+    omp_set_num_threads(thread_count);
+    #pragma omp parallel for simd schedule(static) reduction(+ : sum)
+    for (std::int64_t i = 1; i < count - 1; ++i)
+    {
+        sum += values[i];
+    }
+    return dx * (sum + (values[0] + values[count - 1]) / 2);
+}
+
+double simpson_simd(const double* values, std::int64_t count, double dx)
+{
+    return simpson(values, count, dx, simpson_inner_sum_simd);
+}
+
+double simpson_parallel(const double* values, std::int64_t count, double dx, int thread_count)
+{
+    return simpson(values, count, dx, [thread_count](const double* inner_values, std::int64_t first, std::int64_t last)
+                   {
+                       return simpson_inner_sum_parallel(inner_values, first, last, thread_count);
+                   });
+}
+
+Rule gauss_legendre_rule(int points_count)
+{
+    if (points_count < 1)
+    {
+        throw std::invalid_argument("Gauss-Legendre rule requires at least one point, got " + std::to_string(points_count));
+    }
+
+    Rule rule{ .nodes = std::vector<double>(points_count), .weights = std::vector<double>(points_count) };
+    // Roots are symmetric, only the positive ones are found
+    for (int i = 0; i < (points_count + 1) / 2; ++i)
+    {
+        // Initial guess by Tricomi's approximation of the i-th largest root
+        double x = std::cos(M_PI * (i + 0.75) / (points_count + 0.5));
+        double derivative = 0;
+        for (int iteration = 0; iteration < 100; ++iteration)
+        {
+            // P_n(x) and P_{n-1}(x) by the three-term recurrence
+            double p = 1;
+            double p_previous = 0;
+            for (int k = 1; k <= points_count; ++k)
+            {
+                double p_next = ((2 * k - 1) * x * p - (k - 1) * p_previous) / k;
+                p_previous = p;
+                p = p_next;
+            }
+            derivative = points_count * (x * p - p_previous) / (x * x - 1);
+            double step = p / derivative;
+            x -= step;
+            if (std::fabs(step) < 1e-16)
+            {
+                break;
+            }
+        }
+        double weight = 2 / ((1 - x * x) * derivative * derivative);
+        rule.nodes[i] = -x;
+        rule.nodes[points_count - 1 - i] = x;
+        rule.weights[i] = weight;
+        rule.weights[points_count - 1 - i] = weight;
+    }
+    return rule;
+}
+
+}  // namespace my::quadrature
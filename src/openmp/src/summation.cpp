@@ -0,0 +1,60 @@
+#include <summation.hpp>
+
+#include <omp.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace my::summation
+{
+
+namespace
+{
+
+// Does not depend on the thread count, so neither do the chunk boundaries
+constexpr std::int64_t CHUNK_SIZE = std::int64_t{ 1 } << 14;
+constexpr std::int64_t PARTIAL_SUMS_COUNT = 4;
+
+// Interleaved partial sums give a fixed order of additions, which does not depend on
+// the alignment of values unlike loop peeling of a vectorized reduction
+double chunk_sum(const double* values, std::int64_t count)
+{
+    double partial_sums[PARTIAL_SUMS_COUNT] = {};
+    std::int64_t i = 0;
+    for (; i + PARTIAL_SUMS_COUNT <= count; i += PARTIAL_SUMS_COUNT)
+    {
+        for (std::int64_t j = 0; j < PARTIAL_SUMS_COUNT; ++j)
+        {
+            partial_sums[j] += values[i + j];
+        }
+    }
+    for (; i < count; ++i)
+    {
+        partial_sums[i % PARTIAL_SUMS_COUNT] += values[i];
+    }
+    return (partial_sums[0] + partial_sums[1]) + (partial_sums[2] + partial_sums[3]);
+}
+
+}  // namespace
+
+double reproducible_sum(const double* values, std::int64_t count, int thread_count)
+{
+    std::int64_t chunks_count = (count + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    std::vector<double> chunk_sums(chunks_count);
+    omp_set_num_threads(thread_count);
+    #pragma omp parallel for schedule(static)
+    for (std::int64_t chunk = 0; chunk < chunks_count; ++chunk)
+    {
+        std::int64_t first = chunk * CHUNK_SIZE;
+        chunk_sums[chunk] = chunk_sum(values + first, std::min(CHUNK_SIZE, count - first));
+    }
+
+    NeumaierSum sum;
+    for (double value : chunk_sums)
+    {
+        sum.add(value);
+    }
+    return sum.value();
+}
+
+}  // namespace my::summation
@@ -0,0 +1,303 @@
+#include <table_file.hpp>
+
+#include <precision.hpp>
+#include <quadrature.hpp>
+
+#include <fcntl.h>
+#include <omp.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+namespace my::table_file
+{
+
+namespace
+{
+
+// Closes the descriptor when leaving the scope
+class FileDescriptor
+{
+public:
+    explicit FileDescriptor(const std::string& path)
+        : m_fd(::open(path.c_str(), O_RDONLY))
+    {
+        if (m_fd < 0)
+        {
+            throw std::system_error(errno, std::generic_category(), "Cannot open " + path);
+        }
+    }
+
+    ~FileDescriptor()
+    {
+        ::close(m_fd);
+    }
+
+    FileDescriptor(const FileDescriptor&) = delete;
+    FileDescriptor& operator=(const FileDescriptor&) = delete;
+
+    int get() const
+    {
+        return m_fd;
+    }
+
+private:
+    int m_fd;
+};
+
+// Reads exactly size bytes at offset, retrying short reads
+void read_exactly(int fd, void* buffer, std::size_t size, off_t offset, const std::string& path)
+{
+    char* out = static_cast<char*>(buffer);
+    while (size > 0)
+    {
+        ssize_t result = ::pread(fd, out, size, offset);
+        if (result < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (result < 0)
+        {
+            throw std::system_error(errno, std::generic_category(), "Cannot read " + path);
+        }
+        if (result == 0)
+        {
+            throw std::runtime_error("Unexpected end of " + path);
+        }
+        out += result;
+        size -= static_cast<std::size_t>(result);
+        offset += result;
+    }
+}
+
+void check_header(const TableFileHeader& header, std::uint64_t file_size, const std::string& path)
+{
+    if (std::memcmp(header.magic, TableFileHeader::MAGIC, sizeof(header.magic)) != 0)
+    {
+        throw std::runtime_error(path + " is not a table file");
+    }
+    // Compared by division, so that a corrupted points_count cannot overflow the expected size
+    if (file_size < sizeof(TableFileHeader) ||
+        (file_size - sizeof(TableFileHeader)) % sizeof(double) != 0 ||
+        header.points_count != (file_size - sizeof(TableFileHeader)) / sizeof(double))
+    {
+        throw std::runtime_error("Size of " + path + " does not match the number of points in its header");
+    }
+}
+
+std::uint64_t file_size(int fd, const std::string& path)
+{
+    struct stat status;
+    if (::fstat(fd, &status) != 0)
+    {
+        throw std::system_error(errno, std::generic_category(), "Cannot stat " + path);
+    }
+    return static_cast<std::uint64_t>(status.st_size);
+}
+
+// Advice for the pages of [values + first, values + last). MADV_DONTNEED covers only the pages
+// lying entirely inside the range, since pages at its edges also hold values of the next window
+// or of the block of another thread; other advice covers all pages overlapping the range.
+// Errors are ignored since the advice does not change the result (and this is called inside
+// parallel regions, which exceptions must not leave).
+void advise(const double* values, std::int64_t first, std::int64_t last, int advice)
+{
+    static const std::uintptr_t page_size = static_cast<std::uintptr_t>(::sysconf(_SC_PAGESIZE));
+    std::uintptr_t begin = reinterpret_cast<std::uintptr_t>(values + first);
+    std::uintptr_t end = reinterpret_cast<std::uintptr_t>(values + last);
+    if (advice == MADV_DONTNEED)
+    {
+        begin = (begin + page_size - 1) & ~(page_size - 1);
+        end &= ~(page_size - 1);
+    }
+    else
+    {
+        begin &= ~(page_size - 1);
+    }
+    if (begin < end)
+    {
+        (void)::madvise(reinterpret_cast<void*>(begin), end - begin, advice);
+    }
+}
+
+}  // namespace
+
+TableFileWriter::TableFileWriter(const std::string& path, double from, double dx)
+    : m_path(path)
+    , m_out(path, std::ios::binary | std::ios::trunc)
+    , m_header{}
+{
+    if (!m_out)
+    {
+        throw std::runtime_error("Cannot create " + path);
+    }
+    std::memcpy(m_header.magic, TableFileHeader::MAGIC, sizeof(m_header.magic));
+    m_header.from = from;
+    m_header.dx = dx;
+    // Reserves space for the header
+    m_out.write(reinterpret_cast<const char*>(&m_header), sizeof(m_header));
+}
+
+TableFileWriter::~TableFileWriter()
+{
+    try
+    {
+        close();
+    }
+    catch (...)
+    {
+    }
+}
+
+void TableFileWriter::append(const double* values, std::int64_t count)
+{
+    m_out.write(reinterpret_cast<const char*>(values), static_cast<std::streamsize>(count * sizeof(double)));
+    if (!m_out)
+    {
+        throw std::runtime_error("Cannot write to " + m_path);
+    }
+    m_header.points_count += static_cast<std::uint64_t>(count);
+}
+
+void TableFileWriter::close()
+{
+    if (!m_out.is_open())
+    {
+        return;
+    }
+    m_out.seekp(0);
+    m_out.write(reinterpret_cast<const char*>(&m_header), sizeof(m_header));
+    m_out.close();
+    if (!m_out)
+    {
+        throw std::runtime_error("Cannot write to " + m_path);
+    }
+}
+
+MappedTable::MappedTable(const std::string& path)
+{
+    FileDescriptor fd(path);
+    m_length = file_size(fd.get(), path);
+    if (m_length < sizeof(TableFileHeader))
+    {
+        throw std::runtime_error(path + " is not a table file");
+    }
+    m_data = ::mmap(nullptr, m_length, PROT_READ, MAP_PRIVATE, fd.get(), 0);
+    if (m_data == MAP_FAILED)
+    {
+        throw std::system_error(errno, std::generic_category(), "Cannot map " + path);
+    }
+    try
+    {
+        check_header(header(), m_length, path);
+    }
+    catch (...)
+    {
+        ::munmap(m_data, m_length);
+        throw;
+    }
+    ::madvise(m_data, m_length, MADV_SEQUENTIAL);
+}
+
+MappedTable::~MappedTable()
+{
+    ::munmap(m_data, m_length);
+}
+
+TableFileHeader read_header(const std::string& path)
+{
+    FileDescriptor fd(path);
+    TableFileHeader header;
+    read_exactly(fd.get(), &header, sizeof(header), 0, path);
+    check_header(header, file_size(fd.get(), path), path);
+    return header;
+}
+
+double integrate_mapped_parallel(const MappedTable& table, std::int64_t window_size, int thread_count)
+{
+    if (window_size < 1)
+    {
+        throw std::invalid_argument("Window size must be positive, got " + std::to_string(window_size));
+    }
+    const double* values = table.values();
+    double dx = table.header().dx;
+    std::int64_t size = table.size();
+    double sum = 0;
+    omp_set_num_threads(thread_count);
+    #pragma omp parallel reduction(+ : sum)
+    {
+        auto [first, last] = my::quadrature::static_block(size, omp_get_thread_num(), omp_get_num_threads());
+        for (std::int64_t window = first; window < last; window += window_size)
+        {
+            std::int64_t window_last = std::min(window + window_size, last);
+            advise(values, window_last, std::min(window_last + window_size, last), MADV_WILLNEED);
+            sum += my::precision::accumulate_simd(values + window, window_last - window, dx);
+            advise(values, window, window_last, MADV_DONTNEED);
+        }
+    }
+    return sum;
+}
+
+double integrate_streaming_parallel(const std::string& path, std::int64_t chunk_size, int thread_count)
+{
+    if (chunk_size < 1)
+    {
+        throw std::invalid_argument("Chunk size must be positive, got " + std::to_string(chunk_size));
+    }
+    FileDescriptor fd(path);
+    TableFileHeader header;
+    read_exactly(fd.get(), &header, sizeof(header), 0, path);
+    check_header(header, file_size(fd.get(), path), path);
+    ::posix_fadvise(fd.get(), 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    std::int64_t size = static_cast<std::int64_t>(header.points_count);
+    std::int64_t buffer_size = std::min(chunk_size, size);
+    std::unique_ptr<double[]> current(new double[buffer_size]);
+    std::unique_ptr<double[]> next(new double[buffer_size]);
+    auto read_chunk = [&fd, &path](double* buffer, std::int64_t first, std::int64_t count)
+    {
+        read_exactly(fd.get(), buffer, static_cast<std::size_t>(count) * sizeof(double),
+                     static_cast<off_t>(sizeof(TableFileHeader) + static_cast<std::size_t>(first) * sizeof(double)), path);
+    };
+
+    double sum = 0;
+    omp_set_num_threads(thread_count);
+    std::int64_t count = std::min(buffer_size, size);
+    read_chunk(current.get(), 0, count);
+    for (std::int64_t first = 0; first < size; first += buffer_size)
+    {
+        std::int64_t next_first = first + buffer_size;
+        std::int64_t next_count = std::min(buffer_size, size - next_first);
+        std::future<void> reading;
+        if (next_count > 0)
+        {
+            reading = std::async(std::launch::async, read_chunk, next.get(), next_first, next_count);
+        }
+
+        const double* values = current.get();
+        #pragma omp parallel reduction(+ : sum)
+        {
+            auto [block_first, block_last] = my::quadrature::static_block(count, omp_get_thread_num(), omp_get_num_threads());
+            sum += my::precision::accumulate_simd(values + block_first, block_last - block_first, header.dx);
+        }
+
+        if (reading.valid())
+        {
+            reading.get();
+        }
+        std::swap(current, next);
+        count = next_count;
+    }
+    return sum;
+}
+
+}  // namespace my::table_file
@@ -0,0 +1,93 @@
+#include <benchmark.hpp>
+#include <simd_math.hpp>
+#include <table_file.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Writes the table of the openmp sample integrand to a file, chunk by chunk, so that tables
+// larger than memory can be created:
+//
+//     openmp-write-table <path> [--from=-43.54325] [--to=34.6354] [--dx=0.00001]
+
+namespace
+{
+
+static constexpr std::int64_t CHUNK_SIZE = 1 << 20;
+
+double double_option(int argc, char* argv[], std::string_view name, double default_value)
+{
+    std::optional<std::string_view> value = my::find_cmd_line_option(argc, argv, name);
+    if (!value)
+    {
+        return default_value;
+    }
+    std::string s(*value);
+    try
+    {
+        std::size_t pos;
+        double result = std::stod(s, &pos);
+        if (pos != s.size())
+        {
+            throw std::invalid_argument("stod");
+        }
+        return result;
+    }
+    catch (const std::exception& e)
+    {
+        throw std::invalid_argument("Error: cannot convert --" + std::string(name) + "=\"" + s + "\" to double: \"" + e.what() + "\"");
+    }
+}
+
+// Same as simd_arithmetic_function of the sample
+const auto simd_arithmetic_function = [](auto x)
+{
+    return my::simd_math::exp(my::simd_math::sin(my::simd_math::pow(x, M_PI)));
+};
+
+}  // namespace
+
+int main(int argc, char* argv[]) try
+{
+    std::vector<std::string> args = my::positional_cmd_line_args(argc, argv);
+    if (args.size() != 1)
+    {
+        throw std::invalid_argument("Error: you must pass the path of the table file as CLI-argument");
+    }
+
+    double from = double_option(argc, argv, "from", -43.54325);
+    double to = double_option(argc, argv, "to", 34.6354);
+    double dx = double_option(argc, argv, "dx", 0.00001);
+    if (!(dx > 0) || !(to >= from))
+    {
+        throw std::invalid_argument("Error: expected dx > 0 and to >= from");
+    }
+    std::int64_t points_count = static_cast<std::int64_t>((to - from) / dx) + 1;
+
+    my::table_file::TableFileWriter writer(args[0], from, dx);
+    std::unique_ptr<double[]> buffer(new double[CHUNK_SIZE]);
+    for (std::int64_t first = 0; first < points_count; first += CHUNK_SIZE)
+    {
+        std::int64_t count = std::min(CHUNK_SIZE, points_count - first);
+        my::simd_math::evaluate_points(simd_arithmetic_function, from, dx, first, count, buffer.get());
+        writer.append(buffer.get(), count);
+    }
+    writer.close();
+
+    std::cout << "Written " << points_count << " points (" << points_count * sizeof(double) << " bytes) to " << args[0] << std::endl;
+    return EXIT_SUCCESS;
+}
+catch (const std::exception& e)
+{
+    std::cerr << e.what() << "\nAborting\n";
+    return EXIT_FAILURE;
+}
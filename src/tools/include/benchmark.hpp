@@ -1,16 +1,28 @@
 #ifndef PARALLEL_COMPUTING_TOOLS_BENCHMARK_HPP_
 #define PARALLEL_COMPUTING_TOOLS_BENCHMARK_HPP_
 
+#include <cpuid.h>
+
+#include <algorithm>
 #include <chrono>
-// NOTE: gcc 8.2.0 on cHARISMa does not support concepts
-// Instead, use horrible std::enable_if
-// #include <concepts>
+#include <cmath>
 #include <cstdint>
 #include <cstdlib>
+#include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
 #include <string_view>
 #include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
 
 namespace my
 {
@@ -25,19 +37,152 @@ inline __attribute__((always_inline)) void do_not_optimize(T& value)
 #endif
 }
 
-inline __attribute__((always_inline)) std::uint64_t ticks()
+// Empty asm statement which makes the compiler assume that the value was changed
+// in a register. Prevents hoisting, folding and reassociating of computations on
+// the value without adding any instruction or memory access to them.
+template <typename T>
+inline __attribute__((always_inline)) void keep_in_register(T& value)
+{
+    if constexpr (std::is_integral_v<T>)
+    {
+        asm volatile("" : "+r"(value));
+    }
+    else
+    {
+#if defined(__AVX512F__)
+        asm volatile("" : "+v"(value));
+#else
+        asm volatile("" : "+x"(value));
+#endif
+    }
+}
+
+// Read of TSC at the start of a measured region: lfence waits until all
+// preceding instructions complete locally, so rdtsc cannot be executed early
+inline __attribute__((always_inline)) std::uint64_t ticks_begin()
+{
+    std::uint32_t low, high;
+    asm volatile("lfence; "
+                 "rdtsc"
+                 : "=a"(low), "=d"(high)
+                 :
+                 : "memory");
+    return (static_cast<std::uint64_t>(high) << 32) | low;
+}
+
+// Read of TSC at the end of a measured region: rdtscp waits until all preceding
+// instructions are executed, lfence prevents subsequent ones from starting before the read
+inline __attribute__((always_inline)) std::uint64_t ticks_end()
 {
-    std::uint64_t tsc;
-    asm volatile("mfence; "         // memory barrier
-                 "rdtsc; "          // read of tsc
-                 "shl $32,%%rdx; "  // shift higher 32 bits stored in rdx up
-                 "or %%rdx,%%rax"   // and or onto rax
-                 : "=a"(tsc)        // output to tsc
+    std::uint32_t low, high;
+    asm volatile("rdtscp; "
+                 "lfence"
+                 : "=a"(low), "=d"(high)
                  :
-                 : "%rcx", "%rdx", "memory");
-    return tsc;
+                 : "%rcx", "memory");
+    return (static_cast<std::uint64_t>(high) << 32) | low;
 }
 
+// TSC properties, detected once on first use
+class TscClock
+{
+public:
+    static const TscClock& get_instance()
+    {
+        static TscClock instance;
+        return instance;
+    }
+
+    TscClock(const TscClock&) = delete;
+    TscClock& operator=(const TscClock&) = delete;
+    TscClock(TscClock&&) = delete;
+    TscClock& operator=(TscClock&&) = delete;
+
+    // Invariant TSC runs at a constant rate regardless of P-, C- and T-states,
+    // otherwise ticks are not proportional to time
+    bool invariant() const
+    {
+        return m_invariant;
+    }
+
+    double ticks_per_nanosecond() const
+    {
+        return m_ticks_per_nanosecond;
+    }
+
+    // Ticks spent by an empty ticks_begin() / ticks_end() pair
+    std::uint64_t overhead() const
+    {
+        return m_overhead;
+    }
+
+    double ticks_to_nanoseconds(double ticks) const
+    {
+        return ticks / m_ticks_per_nanosecond;
+    }
+
+private:
+    TscClock()
+        : m_invariant(detect_invariant())
+        , m_overhead(measure_overhead())
+        , m_ticks_per_nanosecond(calibrate())
+    {
+    }
+
+    static bool detect_invariant()
+    {
+        unsigned eax, ebx, ecx, edx;
+        if (__get_cpuid(0x80000000, &eax, &ebx, &ecx, &edx) == 0 || eax < 0x80000007)
+        {
+            return false;
+        }
+        __get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx);
+        return (edx & (1u << 8)) != 0;
+    }
+
+    static std::uint64_t measure_overhead()
+    {
+        static constexpr std::size_t MEASUREMENTS_COUNT = 1'000;
+        std::uint64_t overhead = std::numeric_limits<std::uint64_t>::max();
+        for (std::size_t i = 0; i < MEASUREMENTS_COUNT; ++i)
+        {
+            std::uint64_t before = ticks_begin();
+            std::uint64_t after = ticks_end();
+            overhead = std::min(overhead, after - before);
+        }
+        return overhead;
+    }
+
+    // Busy-wait against steady_clock, best of several short intervals
+    static double calibrate()
+    {
+        using namespace std::chrono;
+        static constexpr std::size_t ROUNDS_COUNT = 5;
+        static constexpr nanoseconds ROUND_DURATION = milliseconds(10);
+
+        std::vector<double> rates;
+        for (std::size_t i = 0; i < ROUNDS_COUNT; ++i)
+        {
+            steady_clock::time_point time_before = steady_clock::now();
+            std::uint64_t ticks_before = ticks_begin();
+            steady_clock::time_point time_after;
+            do
+            {
+                time_after = steady_clock::now();
+            } while (time_after - time_before < ROUND_DURATION);
+            std::uint64_t ticks_after = ticks_end();
+            rates.emplace_back(static_cast<double>(ticks_after - ticks_before) /
+                               static_cast<double>(duration_cast<nanoseconds>(time_after - time_before).count()));
+        }
+        std::sort(rates.begin(), rates.end());
+        return rates[rates.size() / 2];
+    }
+
+    bool m_invariant;
+    std::uint64_t m_overhead;
+    double m_ticks_per_nanosecond;
+};
+
 struct TicksAndNanoseconds
 {
     double ticks;
@@ -80,16 +225,19 @@ public:
     TicksTimer(double& result, std::size_t iterations_count = 1)
         : m_result(result)
         , m_iterations_count(iterations_count)
+        , m_overhead(TscClock::get_instance().overhead())
     {
-        m_ticks_before = ticks();
+        m_ticks_before = ticks_begin();
     }
 
     ~TicksTimer()
     {
         try
         {
-            std::uint64_t ticks_after = ticks();
-            m_result = (ticks_after - m_ticks_before) / static_cast<double>(m_iterations_count);
+            std::uint64_t ticks_after = ticks_end();
+            std::uint64_t elapsed = ticks_after - m_ticks_before;
+            elapsed = elapsed > m_overhead ? elapsed - m_overhead : 0;
+            m_result = elapsed / static_cast<double>(m_iterations_count);
         }
         catch (...)
         {
@@ -100,6 +248,7 @@ public:
 private:
     double& m_result;
     std::size_t m_iterations_count;
+    std::uint64_t m_overhead;
     std::uint64_t m_ticks_before;
 };
 
@@ -113,46 +262,161 @@ public:
     }
 };
 
-// NOTE: gcc 8.2.0 on cHARISMa does not support concepts
-// Instead, use horrible std::enable_if
+struct BenchmarkParams
+{
+    // Iterations run before measurement starts to warm up caches, TLB, branch predictors and CPU frequency
+    std::size_t warmup_count = 10;
+    // Number of timed samples
+    std::size_t samples_count = 100;
+    // Iterations per sample; sample values are normalized to one iteration
+    std::size_t iterations_per_sample = 1;
+    // Exclude samples outside of Tukey's fences from mean, stddev and confidence interval
+    bool reject_outliers = true;
+};
+
+// Order statistics (min, median, p90, p99, max) are computed over all samples,
+// so that tail latency stays visible. Mean, stddev and 95% confidence interval
+// of the mean are computed over samples that survived outlier rejection.
+struct Statistics
+{
+    double min;
+    double median;
+    double p90;
+    double p99;
+    double max;
+    double mean;
+    double stddev;
+    double ci95_low;
+    double ci95_high;
+    std::size_t samples_count;
+    std::size_t outliers_count;
+};
+
+struct BenchmarkResult
+{
+    Statistics ticks;
+    Statistics nanoseconds;
+};
+
+// Linearly interpolated percentile, fraction is in [0; 1], values must be sorted
+inline double percentile(const std::vector<double>& sorted_values, double fraction)
+{
+    if (sorted_values.empty())
+    {
+        throw std::invalid_argument("Cannot compute percentile of an empty sample");
+    }
+    double position = fraction * static_cast<double>(sorted_values.size() - 1);
+    std::size_t lower = static_cast<std::size_t>(position);
+    std::size_t upper = std::min(lower + 1, sorted_values.size() - 1);
+    double weight = position - static_cast<double>(lower);
+    return sorted_values[lower] + weight * (sorted_values[upper] - sorted_values[lower]);
+}
+
+inline Statistics compute_statistics(std::vector<double> samples, bool reject_outliers = true)
+{
+    if (samples.empty())
+    {
+        throw std::invalid_argument("Cannot compute statistics of an empty sample");
+    }
+
+    std::sort(samples.begin(), samples.end());
+
+    Statistics statistics;
+    statistics.min = samples.front();
+    statistics.median = percentile(samples, 0.5);
+    statistics.p90 = percentile(samples, 0.9);
+    statistics.p99 = percentile(samples, 0.99);
+    statistics.max = samples.back();
+
+    auto first = samples.cbegin();
+    auto last = samples.cend();
+    if (reject_outliers)
+    {
+        // Tukey's fences: [q1 - k * iqr; q3 + k * iqr]
+        static constexpr double FENCE_FACTOR = 1.5;
+        double q1 = percentile(samples, 0.25);
+        double q3 = percentile(samples, 0.75);
+        double iqr = q3 - q1;
+        first = std::lower_bound(samples.cbegin(), samples.cend(), q1 - FENCE_FACTOR * iqr);
+        last = std::upper_bound(first, samples.cend(), q3 + FENCE_FACTOR * iqr);
+    }
 
-// template <typename Function>
-// concept ReturnsVoid = std::same_as<std::invoke_result_t<Function>, void>;
+    std::size_t count = static_cast<std::size_t>(last - first);
+    statistics.samples_count = count;
+    statistics.outliers_count = samples.size() - count;
 
-// template <typename Function>
-// concept DoesNotReturnVoid = !ReturnsVoid<Function>;
+    statistics.mean = std::accumulate(first, last, 0.0) / static_cast<double>(count);
+    double squares_sum = std::accumulate(first, last, 0.0,
+                                         [mean = statistics.mean](double sum, double value)
+                                         {
+                                             return sum + (value - mean) * (value - mean);
+                                         });
+    statistics.stddev = count > 1 ? std::sqrt(squares_sum / static_cast<double>(count - 1)) : 0;
+
+    // Normal approximation, good enough for sample sizes we use
+    static constexpr double Z_95 = 1.96;
+    double half_width = Z_95 * statistics.stddev / std::sqrt(static_cast<double>(count));
+    statistics.ci95_low = statistics.mean - half_width;
+    statistics.ci95_high = statistics.mean + half_width;
+
+    return statistics;
+}
+
+namespace detail
+{
 
 template <typename Function>
-// requires DoesNotReturnVoid<Function>
-std::enable_if_t<!std::is_same_v<std::invoke_result_t<Function>, void>, double>
-benchmark_function(Function f, std::size_t iterations_count = 1)
+inline __attribute__((always_inline)) void invoke_and_keep_result(Function& f)
 {
-    double nanoseconds;
+    if constexpr (std::is_same_v<std::invoke_result_t<Function&>, void>)
     {
-        NanosecondsTimer timer(nanoseconds, iterations_count);
-        for (std::size_t i = 0; i < iterations_count; ++i)
-        {
-            auto result = f();
-            do_not_optimize(result);
-        }
+        f();
+    }
+    else
+    {
+        auto result = f();
+        do_not_optimize(result);
     }
-    return nanoseconds;
 }
 
+}  // namespace detail
+
 template <typename Function>
-// requires ReturnsVoid<Function>
-std::enable_if_t<std::is_same_v<std::invoke_result_t<Function>, void>, double>
-benchmark_function(Function f, std::size_t iterations_count = 1)
+BenchmarkResult run_benchmark(Function f, const BenchmarkParams& params = {})
 {
-    double nanoseconds;
+    if (params.samples_count == 0 || params.iterations_per_sample == 0)
     {
-        NanosecondsTimer timer(nanoseconds, iterations_count);
-        for (std::size_t i = 0; i < iterations_count; ++i)
+        throw std::invalid_argument("Samples count and iterations per sample must be positive");
+    }
+
+    // The first call calibrates the TSC for tens of milliseconds, which must not fall into
+    // the first sample (TicksTimer is constructed after NanosecondsTimer has started)
+    TscClock::get_instance();
+
+    for (std::size_t i = 0; i < params.warmup_count; ++i)
+    {
+        detail::invoke_and_keep_result(f);
+    }
+
+    std::vector<TicksAndNanoseconds> samples(params.samples_count);
+    for (TicksAndNanoseconds& sample : samples)
+    {
+        Timer timer(sample, params.iterations_per_sample);
+        for (std::size_t i = 0; i < params.iterations_per_sample; ++i)
         {
-            f();
+            detail::invoke_and_keep_result(f);
         }
     }
-    return nanoseconds;
+
+    std::vector<double> ticks(samples.size());
+    std::vector<double> nanoseconds(samples.size());
+    std::transform(samples.begin(), samples.end(), ticks.begin(),
+                   [](const TicksAndNanoseconds& sample) { return sample.ticks; });
+    std::transform(samples.begin(), samples.end(), nanoseconds.begin(),
+                   [](const TicksAndNanoseconds& sample) { return sample.nanoseconds; });
+
+    return { .ticks = compute_statistics(std::move(ticks), params.reject_outliers),
+             .nanoseconds = compute_statistics(std::move(nanoseconds), params.reject_outliers) };
 }
 
 inline void print_result(std::string_view label, double result)
@@ -163,6 +427,427 @@ inline void print_result(std::string_view label, double result)
     std::cout << std::scientific;
 }
 
+inline void print_result(std::string_view label, const Statistics& result)
+{
+    std::cout << label;
+    std::cout << std::fixed << std::setprecision(2) << std::setfill(' ');
+    std::cout << std::setw(15) << result.median
+              << "  [min " << result.min
+              << ", p90 " << result.p90
+              << ", p99 " << result.p99
+              << ", max " << result.max
+              << "; mean " << result.mean << " +- " << result.ci95_high - result.mean
+              << ", stddev " << result.stddev
+              << ", outliers " << result.outliers_count << "/" << result.samples_count + result.outliers_count
+              << "]" << std::endl;
+    std::cout << std::scientific;
+}
+
+enum class OutputFormat
+{
+    TEXT,
+    JSON,
+    CSV,
+};
+
+inline OutputFormat output_format_from_string(std::string_view value)
+{
+    if (value == "text")
+        return OutputFormat::TEXT;
+    if (value == "json")
+        return OutputFormat::JSON;
+    if (value == "csv")
+        return OutputFormat::CSV;
+    throw std::invalid_argument("Error: unknown output format \"" + std::string(value) + "\", expected text, json or csv");
+}
+
+// Returns value of "--name=value" CLI-argument or std::nullopt if it is absent
+inline std::optional<std::string_view> find_cmd_line_option(int argc, char* argv[], std::string_view name)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string_view arg = argv[i];
+        if (arg.size() > name.size() + 2 && arg.substr(0, 2) == "--" &&
+            arg.substr(2, name.size()) == name && arg[name.size() + 2] == '=')
+        {
+            return arg.substr(name.size() + 3);
+        }
+    }
+    return std::nullopt;
+}
+
+// CLI-arguments which are not "--name=value" options
+inline std::vector<std::string> positional_cmd_line_args(int argc, char* argv[])
+{
+    std::vector<std::string> args;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string_view arg = argv[i];
+        if (arg.substr(0, 2) != "--")
+        {
+            args.emplace_back(arg);
+        }
+    }
+    return args;
+}
+
+inline OutputFormat output_format_from_cmd_line(int argc, char* argv[])
+{
+    std::optional<std::string_view> value = find_cmd_line_option(argc, argv, "format");
+    return value.has_value() ? output_format_from_string(*value) : OutputFormat::TEXT;
+}
+
+// Sample headers (topology, placement, etc.) go to stdout for human-readable
+// output and to stderr otherwise, so that stdout stays machine-readable
+inline std::ostream& header_stream(OutputFormat format)
+{
+    return format == OutputFormat::TEXT ? std::cout : std::cerr;
+}
+
+inline std::string compiler_name()
+{
+#if defined(__INTEL_LLVM_COMPILER)
+    return "icpx " + std::to_string(__INTEL_LLVM_COMPILER);
+#elif defined(__INTEL_COMPILER)
+    return "icpc " + std::to_string(__INTEL_COMPILER);
+#elif defined(__clang__)
+    return "clang++ " __clang_version__;
+#elif defined(__GNUC__)
+    return "g++ " __VERSION__;
+#else
+    return "unknown";
+#endif
+}
+
+inline std::string cpu_model_name()
+{
+    std::ifstream cpuinfo("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(cpuinfo, line))
+    {
+        if (line.rfind("model name", 0) == 0)
+        {
+            std::size_t pos = line.find(':');
+            if (pos != std::string::npos && pos + 2 <= line.size())
+            {
+                return line.substr(pos + 2);
+            }
+        }
+    }
+    return "unknown";
+}
+
+using ParamValue = std::variant<std::int64_t, double, std::string>;
+
+struct BenchmarkRecord
+{
+    std::string name;
+    std::vector<std::pair<std::string, ParamValue>> params;
+    BenchmarkResult result;
+    // Optional derived per-iteration values, e.g. hardware counters
+    std::vector<std::pair<std::string, double>> metrics = {};
+};
+
+class ResultSink
+{
+public:
+    virtual ~ResultSink() = default;
+    virtual void write(const BenchmarkRecord& record) = 0;
+};
+
+// Human-readable output, one line per record with the name right-aligned to label_width
+class TextResultSink : public ResultSink
+{
+public:
+    explicit TextResultSink(std::size_t label_width = 0)
+        : m_label_width(label_width)
+    {
+    }
+
+    void write(const BenchmarkRecord& record) override
+    {
+        std::ostringstream label;
+        label << std::setw(static_cast<int>(m_label_width)) << record.name << ": ";
+        print_result(label.str(), record.result.nanoseconds);
+        if (!record.metrics.empty())
+        {
+            std::cout << std::string(m_label_width + 2, ' ') << std::setprecision(3) << std::defaultfloat;
+            for (const auto& [key, value] : record.metrics)
+            {
+                // Counts and sizes are printed exactly
+                if (value == std::trunc(value) && std::abs(value) < 1e15)
+                {
+                    std::cout << ' ' << key << '=' << static_cast<std::int64_t>(value);
+                }
+                else
+                {
+                    std::cout << ' ' << key << '=' << value;
+                }
+            }
+            std::cout << std::endl;
+        }
+    }
+
+private:
+    std::size_t m_label_width;
+};
+
+namespace detail
+{
+
+inline std::string json_escape(std::string_view value)
+{
+    std::string escaped;
+    escaped.reserve(value.size());
+    for (char c : value)
+    {
+        switch (c)
+        {
+        case '"':  escaped += "\\\""; break;
+        case '\\': escaped += "\\\\"; break;
+        case '\n': escaped += "\\n"; break;
+        case '\t': escaped += "\\t"; break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20)
+            {
+                static constexpr char HEX[] = "0123456789abcdef";
+                escaped += "\\u00";
+                escaped += HEX[(c >> 4) & 0xf];
+                escaped += HEX[c & 0xf];
+            }
+            else
+            {
+                escaped += c;
+            }
+        }
+    }
+    return escaped;
+}
+
+inline std::string csv_escape(std::string_view value)
+{
+    if (value.find_first_of(",\"\n") == std::string_view::npos)
+    {
+        return std::string(value);
+    }
+    std::string escaped = "\"";
+    for (char c : value)
+    {
+        escaped += c;
+        if (c == '"')
+        {
+            escaped += c;
+        }
+    }
+    escaped += '"';
+    return escaped;
+}
+
+// JSON has no literals for NaN and infinities, so they are written as null
+inline void write_json_number(std::ostream& out, double value)
+{
+    if (std::isfinite(value))
+    {
+        out << value;
+    }
+    else
+    {
+        out << "null";
+    }
+}
+
+// NaN and infinities are left as empty CSV fields
+inline void write_csv_number(std::ostream& out, double value)
+{
+    if (std::isfinite(value))
+    {
+        out << value;
+    }
+}
+
+inline void write_json_statistics(std::ostream& out, const Statistics& statistics)
+{
+    const std::pair<const char*, double> values[] = {
+        { "min", statistics.min }, { "median", statistics.median }, { "p90", statistics.p90 },
+        { "p99", statistics.p99 }, { "max", statistics.max }, { "mean", statistics.mean },
+        { "stddev", statistics.stddev }, { "ci95_low", statistics.ci95_low }, { "ci95_high", statistics.ci95_high },
+    };
+    out << "{";
+    for (const auto& [key, value] : values)
+    {
+        out << "\"" << key << "\":";
+        write_json_number(out, value);
+        out << ",";
+    }
+    out << "\"samples\":" << statistics.samples_count
+        << ",\"outliers\":" << statistics.outliers_count << "}";
+}
+
+inline void write_csv_statistics(std::ostream& out, const Statistics& statistics)
+{
+    for (double value : { statistics.min, statistics.median, statistics.p90, statistics.p99, statistics.max,
+                          statistics.mean, statistics.stddev, statistics.ci95_low, statistics.ci95_high })
+    {
+        write_csv_number(out, value);
+        out << ',';
+    }
+    out << statistics.samples_count << ',' << statistics.outliers_count;
+}
+
+}  // namespace detail
+
+// One JSON object per line
+class JsonLinesResultSink : public ResultSink
+{
+public:
+    explicit JsonLinesResultSink(std::string_view benchmark_name)
+        : m_benchmark_name(benchmark_name)
+        , m_compiler(compiler_name())
+        , m_cpu_model(cpu_model_name())
+    {
+    }
+
+    void write(const BenchmarkRecord& record) override
+    {
+        std::ostringstream out;
+        out << std::setprecision(10);
+        out << "{\"benchmark\":\"" << detail::json_escape(m_benchmark_name) << "\""
+            << ",\"name\":\"" << detail::json_escape(record.name) << "\""
+            << ",\"params\":{";
+        for (std::size_t i = 0; i < record.params.size(); ++i)
+        {
+            const auto& [key, value] = record.params[i];
+            out << (i == 0 ? "" : ",") << "\"" << detail::json_escape(key) << "\":";
+            std::visit([&out](const auto& v)
+                       {
+                           if constexpr (std::is_same_v<std::decay_t<decltype(v)>, std::string>)
+                               out << "\"" << detail::json_escape(v) << "\"";
+                           else if constexpr (std::is_same_v<std::decay_t<decltype(v)>, double>)
+                               detail::write_json_number(out, v);
+                           else
+                               out << v;
+                       },
+                       value);
+        }
+        out << "}"
+            << ",\"compiler\":\"" << detail::json_escape(m_compiler) << "\""
+            << ",\"cpu\":\"" << detail::json_escape(m_cpu_model) << "\""
+            << ",\"ticks\":";
+        detail::write_json_statistics(out, record.result.ticks);
+        out << ",\"nanoseconds\":";
+        detail::write_json_statistics(out, record.result.nanoseconds);
+        if (!record.metrics.empty())
+        {
+            out << ",\"metrics\":{";
+            for (std::size_t i = 0; i < record.metrics.size(); ++i)
+            {
+                out << (i == 0 ? "" : ",") << "\"" << detail::json_escape(record.metrics[i].first) << "\":";
+                detail::write_json_number(out, record.metrics[i].second);
+            }
+            out << "}";
+        }
+        out << "}";
+        std::cout << out.str() << std::endl;
+    }
+
+private:
+    std::string m_benchmark_name;
+    std::string m_compiler;
+    std::string m_cpu_model;
+};
+
+// Header line followed by one row per record, params and metrics are packed into "key=value;..." columns
+class CsvResultSink : public ResultSink
+{
+public:
+    explicit CsvResultSink(std::string_view benchmark_name)
+        : m_benchmark_name(benchmark_name)
+        , m_compiler(compiler_name())
+        , m_cpu_model(cpu_model_name())
+    {
+    }
+
+    void write(const BenchmarkRecord& record) override
+    {
+        // Header is written lazily, so that sinks of MPI processes which never write do not print anything
+        if (!m_header_written)
+        {
+            std::cout << "benchmark,name,params,compiler,cpu";
+            for (std::string_view unit : { "ticks", "ns" })
+            {
+                for (std::string_view column : { "min", "median", "p90", "p99", "max", "mean",
+                                                 "stddev", "ci95_low", "ci95_high", "samples", "outliers" })
+                {
+                    std::cout << ',' << unit << '_' << column;
+                }
+            }
+            std::cout << ",metrics" << std::endl;
+            m_header_written = true;
+        }
+
+        std::ostringstream params;
+        params << std::setprecision(10);
+        for (std::size_t i = 0; i < record.params.size(); ++i)
+        {
+            const auto& [key, value] = record.params[i];
+            params << (i == 0 ? "" : ";") << key << '=';
+            std::visit([&params](const auto& v)
+                       {
+                           if constexpr (std::is_same_v<std::decay_t<decltype(v)>, double>)
+                               detail::write_csv_number(params, v);
+                           else
+                               params << v;
+                       },
+                       value);
+        }
+
+        std::ostringstream out;
+        out << std::setprecision(10);
+        out << detail::csv_escape(m_benchmark_name) << ','
+            << detail::csv_escape(record.name) << ','
+            << detail::csv_escape(params.str()) << ','
+            << detail::csv_escape(m_compiler) << ','
+            << detail::csv_escape(m_cpu_model) << ',';
+        detail::write_csv_statistics(out, record.result.ticks);
+        out << ',';
+        detail::write_csv_statistics(out, record.result.nanoseconds);
+
+        std::ostringstream metrics;
+        metrics << std::setprecision(10);
+        for (std::size_t i = 0; i < record.metrics.size(); ++i)
+        {
+            metrics << (i == 0 ? "" : ";") << record.metrics[i].first << '=';
+            detail::write_csv_number(metrics, record.metrics[i].second);
+        }
+        out << ',' << detail::csv_escape(metrics.str());
+
+        std::cout << out.str() << std::endl;
+    }
+
+private:
+    std::string m_benchmark_name;
+    std::string m_compiler;
+    std::string m_cpu_model;
+    bool m_header_written = false;
+};
+
+// For OutputFormat::TEXT returns TextResultSink, samples with their own
+// human-readable layout may construct a custom sink instead
+inline std::unique_ptr<ResultSink> make_result_sink(OutputFormat format, std::string_view benchmark_name,
+                                                   std::size_t text_label_width = 0)
+{
+    switch (format)
+    {
+    case OutputFormat::TEXT:
+        return std::make_unique<TextResultSink>(text_label_width);
+    case OutputFormat::JSON:
+        return std::make_unique<JsonLinesResultSink>(benchmark_name);
+    case OutputFormat::CSV:
+        return std::make_unique<CsvResultSink>(benchmark_name);
+    }
+    throw std::invalid_argument("Error: unknown output format");
+}
+
 }  // namespace my
 
 #endif  // PARALLEL_COMPUTING_TOOLS_BENCHMARK_HPP_
@@ -6,7 +6,17 @@
 #include <mpi.h>
 
 #include <cstddef>
+#include <cstdlib>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <ostream>
 #include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace my::mpi
 {
@@ -20,48 +30,44 @@ public:
     ~Exception() override;
 };
 
-inline void check_code(code_t mpi_code)
+// Text of an error code returned by MPI
+inline std::string error_string(code_t mpi_code)
 {
-    if (mpi_code != MPI_SUCCESS)
+    char text[MPI_MAX_ERROR_STRING];
+    int length;
+    if (MPI_Error_string(mpi_code, text, &length) != MPI_SUCCESS)
     {
-        throw Exception("");
+        return "unknown MPI error " + std::to_string(mpi_code);
     }
+    return std::string(text, static_cast<std::size_t>(length));
 }
 
-class MY_MPI_EXPORT Control
+inline void check_code(code_t mpi_code)
 {
-public:
-    Control(int argc, char* argv[])
-    {
-        if (m_count != 0)
-        {
-            throw std::runtime_error("Only one Control object must be created");
-        }
-        code_t mpi_code = MPI_Init(&argc, &argv);
-        check_code(mpi_code);
-        ++m_count;
-    }
-
-    ~Control()
+    if (mpi_code != MPI_SUCCESS)
     {
-        try
-        {
-            code_t mpi_code = MPI_Finalize();
-            check_code(mpi_code);
-        }
-        catch (...)
-        {
-            std::exit(EXIT_FAILURE);
-        }
+        throw Exception("MPI error: " + error_string(mpi_code));
     }
+}
 
-private:
-    static int m_count;
+// Levels of thread support of MPI_Init_thread
+enum class Threading : int
+{
+    SINGLE = MPI_THREAD_SINGLE,
+    FUNNELED = MPI_THREAD_FUNNELED,
+    SERIALIZED = MPI_THREAD_SERIALIZED,
+    MULTIPLE = MPI_THREAD_MULTIPLE,
 };
 
+// Parses "single", "funneled", "serialized" or "multiple"
+MY_MPI_EXPORT Threading threading_from_string(std::string_view value);
+MY_MPI_EXPORT std::string_view to_string(Threading threading);
+
 class Params
 {
 public:
+    // The first call is collective over COMM (the node communicator is split), so Control
+    // makes it on every process right after initialization and later calls are local
     static Params& get_instance()
     {
         static Params instance;
@@ -83,6 +89,17 @@ public:
         return m_process_count;
     }
 
+    // Id and count of processes sharing the node with the current one
+    std::size_t local_process_id() const
+    {
+        return m_local_process_id;
+    }
+
+    std::size_t local_process_count() const
+    {
+        return m_local_process_count;
+    }
+
 private:
     Params()
     {
@@ -91,10 +108,99 @@ private:
         check_code(mpi_code);
         mpi_code = MPI_Comm_rank(MPI_COMM_WORLD, &m_process_id);
         check_code(mpi_code);
+
+        MPI_Comm node_comm;
+        mpi_code = MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, m_process_id, MPI_INFO_NULL, &node_comm);
+        check_code(mpi_code);
+        mpi_code = MPI_Comm_size(node_comm, &m_local_process_count);
+        check_code(mpi_code);
+        mpi_code = MPI_Comm_rank(node_comm, &m_local_process_id);
+        check_code(mpi_code);
+        mpi_code = MPI_Comm_free(&node_comm);
+        check_code(mpi_code);
     }
 
     int m_process_id;
     int m_process_count;
+    int m_local_process_id;
+    int m_local_process_count;
+};
+
+class MY_MPI_EXPORT Control
+{
+public:
+    Control(int argc, char* argv[])
+    {
+        check_count();
+        code_t mpi_code = MPI_Init(&argc, &argv);
+        check_code(mpi_code);
+        set_error_handler();
+        int provided;
+        mpi_code = MPI_Query_thread(&provided);
+        check_code(mpi_code);
+        m_provided = static_cast<Threading>(provided);
+        Params::get_instance();
+        ++m_count;
+    }
+
+    // Initializes MPI with MPI_Init_thread, throws if the library cannot provide
+    // the required level of thread support
+    Control(int argc, char* argv[], Threading required)
+    {
+        check_count();
+        int provided;
+        code_t mpi_code = MPI_Init_thread(&argc, &argv, static_cast<int>(required), &provided);
+        check_code(mpi_code);
+        m_provided = static_cast<Threading>(provided);
+        // The destructor of an object that failed to construct is not called, so MPI is finalized here
+        if (provided < static_cast<int>(required))
+        {
+            MPI_Finalize();
+            throw std::runtime_error("MPI provides " + std::string(to_string(m_provided)) + " thread support, "
+                                     + std::string(to_string(required)) + " is required");
+        }
+        set_error_handler();
+        Params::get_instance();
+        ++m_count;
+    }
+
+    ~Control()
+    {
+        try
+        {
+            code_t mpi_code = MPI_Finalize();
+            check_code(mpi_code);
+        }
+        catch (...)
+        {
+            std::exit(EXIT_FAILURE);
+        }
+    }
+
+    Threading provided_threading() const
+    {
+        return m_provided;
+    }
+
+private:
+    // Errors are returned to check_code instead of aborting, communicators created
+    // from the world one inherit the handler
+    static void set_error_handler()
+    {
+        code_t mpi_code = MPI_Comm_set_errhandler(MPI_COMM_WORLD, MPI_ERRORS_RETURN);
+        check_code(mpi_code);
+    }
+
+    static void check_count()
+    {
+        if (m_count != 0)
+        {
+            throw std::runtime_error("Only one Control object must be created");
+        }
+    }
+
+    static int m_count;
+    Threading m_provided;
 };
 
 inline constexpr int ROOT_ID = 0;
@@ -143,12 +249,461 @@ inline void reduce(const void* sendbuf, void* recvbuf, int count,
     check_code(code);
 }
 
+inline void allreduce(const void* sendbuf, void* recvbuf, int count,
+                      MPI_Datatype datatype, MPI_Op op)
+{
+    code_t code = MPI_Allreduce(sendbuf, recvbuf, count, datatype, op, COMM);
+    check_code(code);
+}
+
+inline void gather(const void* sendbuf, int sendcount, MPI_Datatype sendtype,
+                   void* recvbuf, int recvcount, MPI_Datatype recvtype)
+{
+    code_t code = MPI_Gather(sendbuf, sendcount, sendtype,
+                             recvbuf, recvcount, recvtype, ROOT_ID, COMM);
+    check_code(code);
+}
+
+inline void allgatherv(const void* sendbuf, int sendcount, MPI_Datatype sendtype,
+                       void* recvbuf, const int recvcounts[], const int displs[], MPI_Datatype recvtype)
+{
+    code_t code = MPI_Allgatherv(sendbuf, sendcount, sendtype,
+                                 recvbuf, recvcounts, displs, recvtype, COMM);
+    check_code(code);
+}
+
 inline void barrier()
 {
     code_t code = MPI_Barrier(COMM);
     check_code(code);
 }
 
+// Typed layer: buffers are spans of elements, MPI datatypes are deduced from element types
+
+// Contiguous elements, T is const for buffers that are only read
+template <typename T>
+class Span
+{
+public:
+    Span(T* data, std::size_t size)
+        : m_data(data)
+        , m_size(size)
+    {
+    }
+
+    // A single value
+    explicit Span(T& value)
+        : m_data(&value)
+        , m_size(1)
+    {
+    }
+
+    // Contiguous containers, e.g. std::vector, boost::container::vector or std::array
+    template <typename Container,
+              typename = std::enable_if_t<std::is_convertible_v<decltype(std::data(std::declval<Container&>())), T*>>>
+    Span(Container& container)
+        : m_data(std::data(container))
+        , m_size(std::size(container))
+    {
+    }
+
+    T* data() const
+    {
+        return m_data;
+    }
+
+    std::size_t size() const
+    {
+        return m_size;
+    }
+
+private:
+    T* m_data;
+    std::size_t m_size;
+};
+
+template <typename T>
+Span(T*, std::size_t) -> Span<T>;
+
+template <typename Container>
+Span(Container&) -> Span<std::remove_pointer_t<decltype(std::data(std::declval<Container&>()))>>;
+
+// MPI datatype of T, specialize for other types
+template <typename T>
+struct Datatype;
+
+template <> struct Datatype<char>               { static MPI_Datatype get() { return MPI_CHAR; } };
+template <> struct Datatype<signed char>        { static MPI_Datatype get() { return MPI_SIGNED_CHAR; } };
+template <> struct Datatype<unsigned char>      { static MPI_Datatype get() { return MPI_UNSIGNED_CHAR; } };
+template <> struct Datatype<short>              { static MPI_Datatype get() { return MPI_SHORT; } };
+template <> struct Datatype<unsigned short>     { static MPI_Datatype get() { return MPI_UNSIGNED_SHORT; } };
+template <> struct Datatype<int>                { static MPI_Datatype get() { return MPI_INT; } };
+template <> struct Datatype<unsigned>           { static MPI_Datatype get() { return MPI_UNSIGNED; } };
+template <> struct Datatype<long>               { static MPI_Datatype get() { return MPI_LONG; } };
+template <> struct Datatype<unsigned long>      { static MPI_Datatype get() { return MPI_UNSIGNED_LONG; } };
+template <> struct Datatype<long long>          { static MPI_Datatype get() { return MPI_LONG_LONG; } };
+template <> struct Datatype<unsigned long long> { static MPI_Datatype get() { return MPI_UNSIGNED_LONG_LONG; } };
+template <> struct Datatype<float>              { static MPI_Datatype get() { return MPI_FLOAT; } };
+template <> struct Datatype<double>             { static MPI_Datatype get() { return MPI_DOUBLE; } };
+template <> struct Datatype<long double>        { static MPI_Datatype get() { return MPI_LONG_DOUBLE; } };
+template <> struct Datatype<bool>               { static MPI_Datatype get() { return MPI_CXX_BOOL; } };
+
+template <typename T>
+MPI_Datatype datatype()
+{
+    return Datatype<std::remove_cv_t<T>>::get();
+}
+
+// Element counts and displacements of vector collectives (e.g. MPI_Scatterv) are 64-bit,
+// MPI_Count appeared in MPI-3
+using Count = MPI_Count;
+using Displacement = MPI_Aint;
+
+namespace detail
+{
+
+// Arrays converted for a non-blocking call of an MPI library without large-count functions,
+// they must stay valid until the call completes
+struct Arguments
+{
+    std::vector<int> send_counts;
+    std::vector<int> send_displs;
+    std::vector<MPI_Datatype> send_types;
+    std::vector<int> recv_counts;
+    std::vector<int> recv_displs;
+    std::vector<MPI_Datatype> recv_types;
+};
+
+}  // namespace detail
+
+// Pending non-blocking or persistent operation. An active request is waited for on
+// destruction, since its buffers are usually destroyed right after it; persistent requests
+// are freed then. Buffers must outlive the request.
+class MY_MPI_EXPORT Request
+{
+public:
+    Request() = default;
+
+    Request(MPI_Request request, bool persistent, std::unique_ptr<detail::Arguments> arguments = nullptr)
+        : m_request(request)
+        , m_persistent(persistent)
+        , m_arguments(std::move(arguments))
+    {
+    }
+
+    ~Request();
+
+    Request(const Request&) = delete;
+    Request& operator=(const Request&) = delete;
+
+    Request(Request&& other) noexcept
+        : m_request(std::exchange(other.m_request, MPI_REQUEST_NULL))
+        , m_persistent(other.m_persistent)
+        , m_arguments(std::move(other.m_arguments))
+    {
+    }
+
+    Request& operator=(Request&& other) noexcept
+    {
+        std::swap(m_request, other.m_request);
+        std::swap(m_persistent, other.m_persistent);
+        std::swap(m_arguments, other.m_arguments);
+        return *this;
+    }
+
+    // Starts a persistent request again
+    void start();
+    void wait();
+    // Also lets the library progress the operation, which many implementations do only inside MPI calls
+    bool test();
+
+    MPI_Request get() const
+    {
+        return m_request;
+    }
+
+    bool is_persistent() const
+    {
+        return m_persistent;
+    }
+
+private:
+    friend class RequestSet;
+
+    MPI_Request m_request = MPI_REQUEST_NULL;
+    bool m_persistent = false;
+    std::unique_ptr<detail::Arguments> m_arguments;
+};
+
+// Requests completed together, e.g. the exchanges of one step of an algorithm
+class MY_MPI_EXPORT RequestSet
+{
+public:
+    RequestSet() = default;
+    ~RequestSet();
+
+    RequestSet(const RequestSet&) = delete;
+    RequestSet& operator=(const RequestSet&) = delete;
+    RequestSet(RequestSet&&) = default;
+    RequestSet& operator=(RequestSet&&) = default;
+
+    void add(Request request);
+
+    std::size_t size() const
+    {
+        return m_requests.size();
+    }
+
+    // Starts all persistent requests of the set with one MPI_Startall
+    void start_all();
+    void wait_all();
+    bool test_all();
+    // Index of a completed request or nothing if no request has completed yet
+    std::optional<std::size_t> test_any();
+
+private:
+    std::vector<Request> m_requests;
+    // Handles of m_requests in one array for MPI_Waitall and friends
+    std::vector<MPI_Request> m_handles;
+
+    void store_handles();
+    void load_handles();
+};
+
+namespace detail
+{
+
+// Calls with 64-bit element counts: MPI-4 libraries get them as they are (MPI_*_c functions),
+// older ones get int counts while counts fit and derived contiguous datatypes otherwise.
+// Predefined reduction operations do not accept derived datatypes, so long reductions are
+// split into several calls there.
+
+MY_MPI_EXPORT void send(const void* buffer, std::size_t count, MPI_Datatype type, int dest, int tag, MPI_Comm comm);
+MY_MPI_EXPORT void recv(void* buffer, std::size_t count, MPI_Datatype type, int source, int tag, MPI_Comm comm);
+MY_MPI_EXPORT Request isend(const void* buffer, std::size_t count, MPI_Datatype type, int dest, int tag, MPI_Comm comm);
+MY_MPI_EXPORT Request irecv(void* buffer, std::size_t count, MPI_Datatype type, int source, int tag, MPI_Comm comm);
+MY_MPI_EXPORT Request send_init(const void* buffer, std::size_t count, MPI_Datatype type, int dest, int tag, MPI_Comm comm);
+MY_MPI_EXPORT Request recv_init(void* buffer, std::size_t count, MPI_Datatype type, int source, int tag, MPI_Comm comm);
+MY_MPI_EXPORT void bcast(void* buffer, std::size_t count, MPI_Datatype type, int root, MPI_Comm comm);
+
+// send_size is the size of the send buffer of root and must be passed on every process, it tells
+// all processes at once whether int counts and displacements fit
+MY_MPI_EXPORT void scatterv(const void* send, std::size_t send_size, const Count* counts, const Displacement* displs,
+                            void* recv, std::size_t recv_count, MPI_Datatype type, int root, MPI_Comm comm);
+MY_MPI_EXPORT Request iscatterv(const void* send, std::size_t send_size, const Count* counts, const Displacement* displs,
+                                void* recv, std::size_t recv_count, MPI_Datatype type, int root, MPI_Comm comm);
+
+MY_MPI_EXPORT void reduce(const void* send, void* recv, std::size_t count, MPI_Datatype type, MPI_Op op, int root, MPI_Comm comm);
+// Without MPI-4 the count must fit int
+MY_MPI_EXPORT Request ireduce(const void* send, void* recv, std::size_t count, MPI_Datatype type, MPI_Op op, int root, MPI_Comm comm);
+MY_MPI_EXPORT void allreduce(const void* send, void* recv, std::size_t count, MPI_Datatype type, MPI_Op op, MPI_Comm comm);
+
+MY_MPI_EXPORT void allgatherv(const void* send, std::size_t send_count, void* recv, std::size_t recv_size,
+                              const Count* counts, const Displacement* displs, MPI_Datatype type, MPI_Comm comm);
+
+}  // namespace detail
+
+// Communicator freed on destruction unless it is borrowed (e.g. the world one), null for
+// processes that are not members of a split. Operations are typed with Span buffers, element
+// counts may exceed the range of int.
+class MY_MPI_EXPORT Communicator
+{
+public:
+    explicit Communicator(MPI_Comm comm = MPI_COMM_NULL, bool owned = true)
+        : m_comm(comm)
+        , m_owned(owned)
+    {
+    }
+
+    // Borrows COMM
+    static Communicator world()
+    {
+        return Communicator(COMM, false);
+    }
+
+    ~Communicator();
+
+    Communicator(const Communicator&) = delete;
+    Communicator& operator=(const Communicator&) = delete;
+
+    Communicator(Communicator&& other) noexcept
+        : m_comm(std::exchange(other.m_comm, MPI_COMM_NULL))
+        , m_owned(other.m_owned)
+    {
+    }
+
+    Communicator& operator=(Communicator&& other) noexcept
+    {
+        std::swap(m_comm, other.m_comm);
+        std::swap(m_owned, other.m_owned);
+        return *this;
+    }
+
+    MPI_Comm get() const
+    {
+        return m_comm;
+    }
+
+    bool is_null() const
+    {
+        return m_comm == MPI_COMM_NULL;
+    }
+
+    int rank() const;
+    int size() const;
+
+    // Collective: processes with the same color form a communicator ranked by key,
+    // MPI_UNDEFINED color gives a null one
+    Communicator split(int color, int key) const;
+    Communicator duplicate() const;
+
+    void barrier() const
+    {
+        check_code(MPI_Barrier(m_comm));
+    }
+
+    template <typename T>
+    void send(Span<T> buffer, int dest, int tag = TAG) const
+    {
+        detail::send(buffer.data(), buffer.size(), datatype<T>(), dest, tag, m_comm);
+    }
+
+    template <typename T>
+    void recv(Span<T> buffer, int source, int tag = TAG) const
+    {
+        detail::recv(buffer.data(), buffer.size(), datatype<T>(), source, tag, m_comm);
+    }
+
+    template <typename T>
+    [[nodiscard]] Request isend(Span<T> buffer, int dest, int tag = TAG) const
+    {
+        return detail::isend(buffer.data(), buffer.size(), datatype<T>(), dest, tag, m_comm);
+    }
+
+    template <typename T>
+    [[nodiscard]] Request irecv(Span<T> buffer, int source, int tag = TAG) const
+    {
+        return detail::irecv(buffer.data(), buffer.size(), datatype<T>(), source, tag, m_comm);
+    }
+
+    // Persistent requests set up an exchange once, which is then repeated with start
+    // (or RequestSet::start_all) and wait without the setup cost
+    template <typename T>
+    [[nodiscard]] Request send_init(Span<T> buffer, int dest, int tag = TAG) const
+    {
+        return detail::send_init(buffer.data(), buffer.size(), datatype<T>(), dest, tag, m_comm);
+    }
+
+    template <typename T>
+    [[nodiscard]] Request recv_init(Span<T> buffer, int source, int tag = TAG) const
+    {
+        return detail::recv_init(buffer.data(), buffer.size(), datatype<T>(), source, tag, m_comm);
+    }
+
+    template <typename T>
+    void bcast(Span<T> buffer, int root = ROOT_ID) const
+    {
+        detail::bcast(buffer.data(), buffer.size(), datatype<T>(), root, m_comm);
+    }
+
+    // counts and displs are read on root only, send must have the same size on every process
+    // (e.g. a null pointer with the global size)
+    template <typename S, typename T>
+    void scatterv(Span<S> send, Span<const Count> counts, Span<const Displacement> displs, Span<T> recv, int root = ROOT_ID) const
+    {
+        static_assert(std::is_same_v<std::remove_cv_t<S>, T>, "Send and receive buffers must have the same element type");
+        detail::scatterv(send.data(), send.size(), counts.data(), displs.data(), recv.data(), recv.size(), datatype<T>(), root, m_comm);
+    }
+
+    template <typename S, typename T>
+    [[nodiscard]] Request iscatterv(Span<S> send, Span<const Count> counts, Span<const Displacement> displs, Span<T> recv, int root = ROOT_ID) const
+    {
+        static_assert(std::is_same_v<std::remove_cv_t<S>, T>, "Send and receive buffers must have the same element type");
+        return detail::iscatterv(send.data(), send.size(), counts.data(), displs.data(), recv.data(), recv.size(), datatype<T>(), root, m_comm);
+    }
+
+    template <typename S, typename T>
+    void reduce(Span<S> send, Span<T> recv, MPI_Op op, int root = ROOT_ID) const
+    {
+        static_assert(std::is_same_v<std::remove_cv_t<S>, T>, "Send and receive buffers must have the same element type");
+        detail::reduce(send.data(), recv.data(), send.size(), datatype<T>(), op, root, m_comm);
+    }
+
+    template <typename S, typename T>
+    [[nodiscard]] Request ireduce(Span<S> send, Span<T> recv, MPI_Op op, int root = ROOT_ID) const
+    {
+        static_assert(std::is_same_v<std::remove_cv_t<S>, T>, "Send and receive buffers must have the same element type");
+        return detail::ireduce(send.data(), recv.data(), send.size(), datatype<T>(), op, root, m_comm);
+    }
+
+    template <typename S, typename T>
+    void allreduce(Span<S> send, Span<T> recv, MPI_Op op) const
+    {
+        static_assert(std::is_same_v<std::remove_cv_t<S>, T>, "Send and receive buffers must have the same element type");
+        detail::allreduce(send.data(), recv.data(), send.size(), datatype<T>(), op, m_comm);
+    }
+
+    // Single value, the result is returned on every process
+    template <typename T>
+    T allreduce(T value, MPI_Op op) const
+    {
+        T result;
+        check_code(MPI_Allreduce(&value, &result, 1, datatype<T>(), op, m_comm));
+        return result;
+    }
+
+    template <typename S, typename T>
+    void allgatherv(Span<S> send, Span<T> recv, Span<const Count> counts, Span<const Displacement> displs) const
+    {
+        static_assert(std::is_same_v<std::remove_cv_t<S>, T>, "Send and receive buffers must have the same element type");
+        detail::allgatherv(send.data(), send.size(), recv.data(), recv.size(), counts.data(), displs.data(), datatype<T>(), m_comm);
+    }
+
+private:
+    MPI_Comm m_comm;
+    bool m_owned;
+};
+
+// Collective: processes of comm that share memory, i.e. run on the same node,
+// ranked in the order of their ranks in comm
+MY_MPI_EXPORT Communicator split_shared(MPI_Comm comm = COMM);
+
+// Collective: processes of comm with rank 0 in node, one per node, ranked in the order
+// of their ranks in comm; null for other processes
+MY_MPI_EXPORT Communicator split_node_leaders(const Communicator& node, MPI_Comm comm = COMM);
+
+// Memory allocated with MPI_Win_allocate_shared, which every process of a node
+// communicator can access directly with loads and stores. Allocations of all processes
+// are contiguous in the order of their ranks. The window stays in a passive target epoch
+// (MPI_Win_lock_all) for its lifetime, so accesses are ordered with synchronize().
+class MY_MPI_EXPORT SharedWindow
+{
+public:
+    // Collective over node: the current process contributes size bytes to the window,
+    // node must outlive the window
+    SharedWindow(const Communicator& node, std::size_t size);
+    ~SharedWindow();
+
+    SharedWindow(const SharedWindow&) = delete;
+    SharedWindow& operator=(const SharedWindow&) = delete;
+
+    // Memory contributed by the process with rank in node and its size in bytes
+    void* data(int rank) const;
+    std::size_t size(int rank) const;
+
+    // Collective over node: makes stores of every process before the call visible to loads
+    // of every process after it
+    void synchronize();
+
+private:
+    MPI_Comm m_node;
+    MPI_Win m_window;
+};
+
+// Collective: gathers host name and CPU of every process and prints
+// them on root, cpu is the one the calling process is pinned to or runs on
+MY_MPI_EXPORT void report_placement(std::ostream& out, int cpu);
+
 }  // namespace my::mpi
 
 #endif  // PARALLEL_COMPUTING_TOOLS_MPI_HPP_
@@ -0,0 +1,238 @@
+#ifndef PARALLEL_COMPUTING_TOOLS_PERF_COUNTERS_HPP_
+#define PARALLEL_COMPUTING_TOOLS_PERF_COUNTERS_HPP_
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace my
+{
+
+// Values are normalized to one iteration, counters which
+// could not be opened (e.g. inside a container) are std::nullopt
+struct PerfCounters
+{
+    std::optional<double> cycles;
+    std::optional<double> instructions;
+    std::optional<double> llc_misses;
+    std::optional<double> branch_misses;
+    std::optional<double> stalled_cycles;
+
+    std::optional<double> ipc() const
+    {
+        if (!cycles.has_value() || !instructions.has_value() || *cycles == 0)
+            return std::nullopt;
+        return *instructions / *cycles;
+    }
+
+    std::optional<double> bytes_per_cycle(double bytes_per_iteration) const
+    {
+        if (!cycles.has_value() || *cycles == 0)
+            return std::nullopt;
+        return bytes_per_iteration / *cycles;
+    }
+
+    // Flat list of available values, suitable for BenchmarkRecord::metrics. bytes_per_cycle
+    // is reported only for kernels with known memory traffic per iteration.
+    std::vector<std::pair<std::string, double>> to_metrics(std::optional<double> bytes_per_iteration) const
+    {
+        std::vector<std::pair<std::string, double>> metrics;
+        auto add = [&metrics](const char* name, std::optional<double> value)
+        {
+            if (value.has_value())
+                metrics.emplace_back(name, *value);
+        };
+        add("cycles", cycles);
+        add("instructions", instructions);
+        add("llc_misses", llc_misses);
+        add("branch_misses", branch_misses);
+        add("stalled_cycles", stalled_cycles);
+        add("ipc", ipc());
+        if (bytes_per_iteration.has_value())
+            add("bytes_per_cycle", bytes_per_cycle(*bytes_per_iteration));
+        return metrics;
+    }
+};
+
+// Set of hardware counters opened with perf_event_open for one or several threads.
+// Counters of a thread only count events of that thread, so every thread taking
+// part in the measurement (e.g. each OpenMP thread) must call add_current_thread().
+// Counters stay enabled all the time, PerfCounterTimer reads them before and after
+// the measured block.
+class PerfEventSet
+{
+public:
+    static constexpr std::size_t EVENTS_COUNT = 5;
+    using values_t = std::array<std::optional<double>, EVENTS_COUNT>;
+
+    PerfEventSet() = default;
+    PerfEventSet(const PerfEventSet&) = delete;
+    PerfEventSet& operator=(const PerfEventSet&) = delete;
+    PerfEventSet(PerfEventSet&&) = delete;
+    PerfEventSet& operator=(PerfEventSet&&) = delete;
+
+    ~PerfEventSet()
+    {
+        for (const auto& thread_fds : m_fds)
+        {
+            for (int fd : thread_fds)
+            {
+                if (fd != -1)
+                    ::close(fd);
+            }
+        }
+    }
+
+    // Thread-safe
+    void add_current_thread()
+    {
+        static constexpr std::array<std::uint64_t, EVENTS_COUNT> CONFIGS =
+        {
+            PERF_COUNT_HW_CPU_CYCLES,
+            PERF_COUNT_HW_INSTRUCTIONS,
+            PERF_COUNT_HW_CACHE_MISSES,
+            PERF_COUNT_HW_BRANCH_MISSES,
+            PERF_COUNT_HW_STALLED_CYCLES_BACKEND,
+        };
+
+        std::array<int, EVENTS_COUNT> thread_fds;
+        for (std::size_t i = 0; i < EVENTS_COUNT; ++i)
+        {
+            perf_event_attr attr{};
+            attr.size = sizeof(attr);
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = CONFIGS[i];
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            thread_fds[i] = static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_fds.emplace_back(thread_fds);
+    }
+
+    // True if at least one counter could be opened
+    bool available() const
+    {
+        for (const auto& thread_fds : m_fds)
+        {
+            for (int fd : thread_fds)
+            {
+                if (fd != -1)
+                    return true;
+            }
+        }
+        return false;
+    }
+
+    // Raw counter values summed over threads, scaled in case counters were multiplexed
+    struct Snapshot
+    {
+        std::array<std::vector<std::array<std::uint64_t, 3>>, EVENTS_COUNT> raw;
+    };
+
+    Snapshot snapshot() const
+    {
+        Snapshot snapshot;
+        for (std::size_t i = 0; i < EVENTS_COUNT; ++i)
+        {
+            snapshot.raw[i].reserve(m_fds.size());
+            for (const auto& thread_fds : m_fds)
+            {
+                // value, time enabled, time running
+                std::array<std::uint64_t, 3> data{};
+                if (thread_fds[i] == -1 || ::read(thread_fds[i], data.data(), sizeof(data)) != sizeof(data))
+                {
+                    data = { 0, 0, 0 };
+                }
+                snapshot.raw[i].emplace_back(data);
+            }
+        }
+        return snapshot;
+    }
+
+    values_t difference(const Snapshot& before, const Snapshot& after) const
+    {
+        values_t values;
+        for (std::size_t i = 0; i < EVENTS_COUNT; ++i)
+        {
+            bool opened = false;
+            double sum = 0;
+            for (std::size_t thread = 0; thread < m_fds.size(); ++thread)
+            {
+                if (m_fds[thread][i] == -1)
+                    continue;
+                opened = true;
+                const auto& b = before.raw[i][thread];
+                const auto& a = after.raw[i][thread];
+                double value = static_cast<double>(a[0] - b[0]);
+                double enabled = static_cast<double>(a[1] - b[1]);
+                double running = static_cast<double>(a[2] - b[2]);
+                sum += (running > 0 ? value * enabled / running : value);
+            }
+            if (opened)
+                values[i] = sum;
+        }
+        return values;
+    }
+
+private:
+    std::mutex m_mutex;
+    std::vector<std::array<int, EVENTS_COUNT>> m_fds;
+};
+
+class PerfCounterTimer
+{
+public:
+    PerfCounterTimer(const PerfEventSet& events, PerfCounters& result, std::size_t iterations_count = 1)
+        : m_events(events)
+        , m_result(result)
+        , m_iterations_count(iterations_count)
+    {
+        m_before = m_events.snapshot();
+    }
+
+    ~PerfCounterTimer()
+    {
+        try
+        {
+            PerfEventSet::Snapshot after = m_events.snapshot();
+            PerfEventSet::values_t values = m_events.difference(m_before, after);
+            for (auto& value : values)
+            {
+                if (value.has_value())
+                    *value /= static_cast<double>(m_iterations_count);
+            }
+            m_result = PerfCounters{ .cycles = values[0],
+                                     .instructions = values[1],
+                                     .llc_misses = values[2],
+                                     .branch_misses = values[3],
+                                     .stalled_cycles = values[4] };
+        }
+        catch (...)
+        {
+            std::exit(EXIT_FAILURE);
+        }
+    }
+
+private:
+    const PerfEventSet& m_events;
+    PerfCounters& m_result;
+    std::size_t m_iterations_count;
+    PerfEventSet::Snapshot m_before;
+};
+
+}  // namespace my
+
+#endif  // PARALLEL_COMPUTING_TOOLS_PERF_COUNTERS_HPP_
@@ -0,0 +1,89 @@
+#ifndef PARALLEL_COMPUTING_TOOLS_TOPOLOGY_HPP_
+#define PARALLEL_COMPUTING_TOOLS_TOPOLOGY_HPP_
+
+#include <my/topology/export.h>
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace my::topology
+{
+
+struct Cpu
+{
+    int id;
+    int package_id;
+    int core_id;
+    int numa_node;
+    // Position of this hardware thread among SMT siblings of its core
+    int smt_index;
+};
+
+class MY_TOPOLOGY_EXPORT Topology
+{
+public:
+    // Reads /sys/devices/system/{cpu,node}, only CPUs from the affinity
+    // mask of the calling thread (e.g. restricted by Slurm) are included
+    static Topology detect();
+
+    const std::vector<Cpu>& cpus() const
+    {
+        return m_cpus;
+    }
+
+    std::size_t packages_count() const;
+    std::size_t cores_count() const;
+    std::size_t numa_nodes_count() const;
+
+    // E.g. "2 sockets, 16 cores, 32 hardware threads, 2 NUMA nodes"
+    std::string describe() const;
+
+private:
+    explicit Topology(std::vector<Cpu> cpus)
+        : m_cpus(std::move(cpus))
+    {
+    }
+
+    std::vector<Cpu> m_cpus;
+};
+
+enum class PinningPolicy
+{
+    // Leave placement to the OS scheduler
+    NONE,
+    // Consecutive slots share a core, then a socket
+    COMPACT,
+    // Consecutive slots are spread across sockets, then cores, then SMT siblings
+    SCATTER,
+    // Slots are pinned to CPUs from a user-defined list
+    EXPLICIT,
+};
+
+struct Pinning
+{
+    PinningPolicy policy = PinningPolicy::NONE;
+    // Used with PinningPolicy::EXPLICIT only
+    std::vector<int> cpu_list = {};
+};
+
+// Accepts "none", "compact", "scatter" or an explicit CPU list like "0,2,4-7"
+MY_TOPOLOGY_EXPORT Pinning pinning_from_string(std::string_view value);
+
+MY_TOPOLOGY_EXPORT std::string_view to_string(PinningPolicy policy);
+
+// CPU for every slot (thread or process) out of slots_count, empty for PinningPolicy::NONE.
+// Throws std::invalid_argument if there are more slots than CPUs.
+MY_TOPOLOGY_EXPORT std::vector<int> make_placement(const Topology& topology, const Pinning& pinning, std::size_t slots_count);
+
+// Throws std::system_error on failure
+MY_TOPOLOGY_EXPORT void pin_current_thread(int cpu);
+
+// CPU the calling thread is running on right now
+MY_TOPOLOGY_EXPORT int current_cpu();
+
+}  // namespace my::topology
+
+#endif  // PARALLEL_COMPUTING_TOOLS_TOPOLOGY_HPP_
@@ -1,5 +1,15 @@
 #include <mpi.hpp>
 
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
 namespace my::mpi
 {
 
@@ -9,4 +19,716 @@ int Control::m_count = 0;
 
 extern const MPI_Comm COMM = MPI_COMM_WORLD;
 
+Threading threading_from_string(std::string_view value)
+{
+    if (value == "single")
+        return Threading::SINGLE;
+    if (value == "funneled")
+        return Threading::FUNNELED;
+    if (value == "serialized")
+        return Threading::SERIALIZED;
+    if (value == "multiple")
+        return Threading::MULTIPLE;
+
+    throw std::invalid_argument("Error: unknown MPI threading level \"" + std::string(value) + "\"");
+}
+
+std::string_view to_string(Threading threading)
+{
+    switch (threading)
+    {
+    case Threading::SINGLE:     return "single";
+    case Threading::FUNNELED:   return "funneled";
+    case Threading::SERIALIZED: return "serialized";
+    case Threading::MULTIPLE:   return "multiple";
+    }
+    return "unknown";
+}
+
+Request::~Request()
+{
+    if (m_request == MPI_REQUEST_NULL)
+    {
+        return;
+    }
+    MPI_Wait(&m_request, MPI_STATUS_IGNORE);
+    if (m_persistent)
+    {
+        MPI_Request_free(&m_request);
+    }
+}
+
+void Request::start()
+{
+    if (!m_persistent)
+    {
+        throw Exception("Only persistent requests can be started");
+    }
+    check_code(MPI_Start(&m_request));
+}
+
+void Request::wait()
+{
+    check_code(MPI_Wait(&m_request, MPI_STATUS_IGNORE));
+}
+
+bool Request::test()
+{
+    int flag;
+    check_code(MPI_Test(&m_request, &flag, MPI_STATUS_IGNORE));
+    return flag != 0;
+}
+
+RequestSet::~RequestSet()
+{
+    try
+    {
+        wait_all();
+    }
+    catch (...)
+    {
+    }
+}
+
+void RequestSet::add(Request request)
+{
+    m_requests.push_back(std::move(request));
+}
+
+// Completion changes the handles of non-persistent requests to MPI_REQUEST_NULL,
+// so handles are copied to a contiguous array before a call and back after it
+void RequestSet::store_handles()
+{
+    m_handles.resize(m_requests.size());
+    for (std::size_t i = 0; i < m_requests.size(); ++i)
+    {
+        m_handles[i] = m_requests[i].get();
+    }
+}
+
+void RequestSet::load_handles()
+{
+    for (std::size_t i = 0; i < m_requests.size(); ++i)
+    {
+        m_requests[i].m_request = m_handles[i];
+    }
+}
+
+void RequestSet::start_all()
+{
+    for (const Request& request : m_requests)
+    {
+        if (!request.is_persistent())
+        {
+            throw Exception("Only persistent requests can be started");
+        }
+    }
+    store_handles();
+    code_t code = MPI_Startall(static_cast<int>(m_handles.size()), m_handles.data());
+    load_handles();
+    check_code(code);
+}
+
+void RequestSet::wait_all()
+{
+    store_handles();
+    code_t code = MPI_Waitall(static_cast<int>(m_handles.size()), m_handles.data(), MPI_STATUSES_IGNORE);
+    load_handles();
+    check_code(code);
+}
+
+bool RequestSet::test_all()
+{
+    store_handles();
+    int flag;
+    code_t code = MPI_Testall(static_cast<int>(m_handles.size()), m_handles.data(), &flag, MPI_STATUSES_IGNORE);
+    load_handles();
+    check_code(code);
+    return flag != 0;
+}
+
+std::optional<std::size_t> RequestSet::test_any()
+{
+    store_handles();
+    int index;
+    int flag;
+    code_t code = MPI_Testany(static_cast<int>(m_handles.size()), m_handles.data(), &index, &flag, MPI_STATUS_IGNORE);
+    load_handles();
+    check_code(code);
+    if (flag == 0 || index == MPI_UNDEFINED)
+    {
+        return std::nullopt;
+    }
+    return static_cast<std::size_t>(index);
+}
+
+namespace detail
+{
+
+#if MPI_VERSION >= 4
+
+void send(const void* buffer, std::size_t count, MPI_Datatype type, int dest, int tag, MPI_Comm comm)
+{
+    check_code(MPI_Send_c(buffer, static_cast<MPI_Count>(count), type, dest, tag, comm));
+}
+
+void recv(void* buffer, std::size_t count, MPI_Datatype type, int source, int tag, MPI_Comm comm)
+{
+    check_code(MPI_Recv_c(buffer, static_cast<MPI_Count>(count), type, source, tag, comm, MPI_STATUS_IGNORE));
+}
+
+Request isend(const void* buffer, std::size_t count, MPI_Datatype type, int dest, int tag, MPI_Comm comm)
+{
+    MPI_Request request;
+    check_code(MPI_Isend_c(buffer, static_cast<MPI_Count>(count), type, dest, tag, comm, &request));
+    return Request(request, false);
+}
+
+Request irecv(void* buffer, std::size_t count, MPI_Datatype type, int source, int tag, MPI_Comm comm)
+{
+    MPI_Request request;
+    check_code(MPI_Irecv_c(buffer, static_cast<MPI_Count>(count), type, source, tag, comm, &request));
+    return Request(request, false);
+}
+
+Request send_init(const void* buffer, std::size_t count, MPI_Datatype type, int dest, int tag, MPI_Comm comm)
+{
+    MPI_Request request;
+    check_code(MPI_Send_init_c(buffer, static_cast<MPI_Count>(count), type, dest, tag, comm, &request));
+    return Request(request, true);
+}
+
+Request recv_init(void* buffer, std::size_t count, MPI_Datatype type, int source, int tag, MPI_Comm comm)
+{
+    MPI_Request request;
+    check_code(MPI_Recv_init_c(buffer, static_cast<MPI_Count>(count), type, source, tag, comm, &request));
+    return Request(request, true);
+}
+
+void bcast(void* buffer, std::size_t count, MPI_Datatype type, int root, MPI_Comm comm)
+{
+    check_code(MPI_Bcast_c(buffer, static_cast<MPI_Count>(count), type, root, comm));
+}
+
+void scatterv(const void* send, std::size_t /* send_size */, const Count* counts, const Displacement* displs,
+              void* recv, std::size_t recv_count, MPI_Datatype type, int root, MPI_Comm comm)
+{
+    check_code(MPI_Scatterv_c(send, counts, displs, type, recv, static_cast<MPI_Count>(recv_count), type, root, comm));
+}
+
+Request iscatterv(const void* send, std::size_t /* send_size */, const Count* counts, const Displacement* displs,
+                  void* recv, std::size_t recv_count, MPI_Datatype type, int root, MPI_Comm comm)
+{
+    MPI_Request request;
+    check_code(MPI_Iscatterv_c(send, counts, displs, type, recv, static_cast<MPI_Count>(recv_count), type, root, comm, &request));
+    return Request(request, false);
+}
+
+void reduce(const void* send, void* recv, std::size_t count, MPI_Datatype type, MPI_Op op, int root, MPI_Comm comm)
+{
+    check_code(MPI_Reduce_c(send, recv, static_cast<MPI_Count>(count), type, op, root, comm));
+}
+
+Request ireduce(const void* send, void* recv, std::size_t count, MPI_Datatype type, MPI_Op op, int root, MPI_Comm comm)
+{
+    MPI_Request request;
+    check_code(MPI_Ireduce_c(send, recv, static_cast<MPI_Count>(count), type, op, root, comm, &request));
+    return Request(request, false);
+}
+
+void allreduce(const void* send, void* recv, std::size_t count, MPI_Datatype type, MPI_Op op, MPI_Comm comm)
+{
+    check_code(MPI_Allreduce_c(send, recv, static_cast<MPI_Count>(count), type, op, comm));
+}
+
+void allgatherv(const void* send, std::size_t send_count, void* recv, std::size_t /* recv_size */,
+                const Count* counts, const Displacement* displs, MPI_Datatype type, MPI_Comm comm)
+{
+    check_code(MPI_Allgatherv_c(send, static_cast<MPI_Count>(send_count), type, recv, counts, displs, type, comm));
+}
+
+#else
+
+namespace
+{
+
+bool fits_int(std::size_t count)
+{
+    return count <= static_cast<std::size_t>(std::numeric_limits<int>::max());
+}
+
+int to_int(std::size_t count)
+{
+    if (!fits_int(count))
+    {
+        throw Exception("Count " + std::to_string(count) + " does not fit int, MPI-4 is required");
+    }
+    return static_cast<int>(count);
+}
+
+// Derived datatypes are built of blocks of this many elements
+constexpr std::size_t LARGE_BLOCK_SIZE = std::size_t{ 1 } << 30;
+
+// Datatypes built for one call. They are freed right after the call, which is allowed
+// even if it has not completed yet.
+class DerivedTypes
+{
+public:
+    DerivedTypes() = default;
+
+    ~DerivedTypes()
+    {
+        for (MPI_Datatype& type : m_types)
+        {
+            MPI_Type_free(&type);
+        }
+    }
+
+    DerivedTypes(const DerivedTypes&) = delete;
+    DerivedTypes& operator=(const DerivedTypes&) = delete;
+
+    // count elements of type starting displacement bytes after the buffer as one element
+    MPI_Datatype make(std::size_t count, MPI_Datatype type, MPI_Aint displacement = 0)
+    {
+        MPI_Datatype elements = make_contiguous(count, type);
+        MPI_Datatype result = elements;
+        if (displacement != 0)
+        {
+            int length = 1;
+            code_t code = MPI_Type_create_struct(1, &length, &displacement, &elements, &result);
+            MPI_Type_free(&elements);
+            check_code(code);
+        }
+        check_code(MPI_Type_commit(&result));
+        m_types.push_back(result);
+        return result;
+    }
+
+    // count elements of type as an int count of a datatype: type itself while count fits int
+    std::pair<int, MPI_Datatype> as_int_count(std::size_t count, MPI_Datatype type)
+    {
+        if (fits_int(count))
+        {
+            return { static_cast<int>(count), type };
+        }
+        return { 1, make(count, type) };
+    }
+
+private:
+    // Uncommitted datatype of count contiguous elements: blocks of LARGE_BLOCK_SIZE elements
+    // followed by the remainder
+    static MPI_Datatype make_contiguous(std::size_t count, MPI_Datatype type)
+    {
+        MPI_Datatype result;
+        if (fits_int(count))
+        {
+            check_code(MPI_Type_contiguous(static_cast<int>(count), type, &result));
+            return result;
+        }
+
+        std::size_t blocks_count = count / LARGE_BLOCK_SIZE;
+        std::size_t remainder = count % LARGE_BLOCK_SIZE;
+        MPI_Datatype block, blocks;
+        check_code(MPI_Type_contiguous(static_cast<int>(LARGE_BLOCK_SIZE), type, &block));
+        code_t code = MPI_Type_contiguous(to_int(blocks_count), block, &blocks);
+        MPI_Type_free(&block);
+        check_code(code);
+        if (remainder == 0)
+        {
+            return blocks;
+        }
+
+        MPI_Aint lower_bound, extent;
+        check_code(MPI_Type_get_extent(type, &lower_bound, &extent));
+        int lengths[2] = { 1, static_cast<int>(remainder) };
+        MPI_Aint displs[2] = { 0, static_cast<MPI_Aint>(blocks_count * LARGE_BLOCK_SIZE) * extent };
+        MPI_Datatype types[2] = { blocks, type };
+        code = MPI_Type_create_struct(2, lengths, displs, types, &result);
+        MPI_Type_free(&blocks);
+        check_code(code);
+        return result;
+    }
+
+    std::vector<MPI_Datatype> m_types;
+};
+
+MPI_Aint extent_of(MPI_Datatype type)
+{
+    MPI_Aint lower_bound, extent;
+    check_code(MPI_Type_get_extent(type, &lower_bound, &extent));
+    return extent;
+}
+
+// Buffer advanced by bytes, null and MPI_IN_PLACE buffers are kept as they are
+template <typename T>
+T* advance(T* buffer, MPI_Aint bytes)
+{
+    if (buffer == nullptr || buffer == MPI_IN_PLACE)
+    {
+        return buffer;
+    }
+    using byte_t = std::conditional_t<std::is_const_v<T>, const char, char>;
+    return static_cast<byte_t*>(buffer) + bytes;
+}
+
+// Arguments of one MPI_Scatterv or MPI_Iscatterv call. Counts and displacements fit int if the send
+// buffer does, which all processes know from its size, otherwise every block is described by a
+// derived datatype and sent with MPI_Alltoallw, whose displacements are in bytes and datatypes
+// are separate for every process.
+std::unique_ptr<Arguments> make_scatterv_arguments(std::size_t send_size, const Count* counts, const Displacement* displs,
+                                                   std::size_t recv_count, MPI_Datatype type, int root, MPI_Comm comm,
+                                                   DerivedTypes& derived_types)
+{
+    int rank, size;
+    check_code(MPI_Comm_rank(comm, &rank));
+    check_code(MPI_Comm_size(comm, &size));
+    auto arguments = std::make_unique<Arguments>();
+
+    if (fits_int(send_size))
+    {
+        if (rank == root)
+        {
+            arguments->send_counts.assign(counts, counts + size);
+            arguments->send_displs.assign(displs, displs + size);
+        }
+        return arguments;
+    }
+
+    arguments->send_counts.assign(size, 0);
+    arguments->send_displs.assign(size, 0);
+    arguments->send_types.assign(size, type);
+    if (rank == root)
+    {
+        MPI_Aint extent = extent_of(type);
+        for (int i = 0; i < size; ++i)
+        {
+            if (counts[i] > 0)
+            {
+                arguments->send_counts[i] = 1;
+                arguments->send_types[i] = derived_types.make(static_cast<std::size_t>(counts[i]), type, displs[i] * extent);
+            }
+        }
+    }
+
+    arguments->recv_counts.assign(size, 0);
+    arguments->recv_displs.assign(size, 0);
+    arguments->recv_types.assign(size, type);
+    if (recv_count > 0)
+    {
+        arguments->recv_counts[root] = 1;
+        arguments->recv_types[root] = derived_types.make(recv_count, type);
+    }
+    return arguments;
+}
+
+}  // namespace
+
+void send(const void* buffer, std::size_t count, MPI_Datatype type, int dest, int tag, MPI_Comm comm)
+{
+    DerivedTypes derived_types;
+    auto [int_count, int_type] = derived_types.as_int_count(count, type);
+    check_code(MPI_Send(buffer, int_count, int_type, dest, tag, comm));
+}
+
+void recv(void* buffer, std::size_t count, MPI_Datatype type, int source, int tag, MPI_Comm comm)
+{
+    DerivedTypes derived_types;
+    auto [int_count, int_type] = derived_types.as_int_count(count, type);
+    check_code(MPI_Recv(buffer, int_count, int_type, source, tag, comm, MPI_STATUS_IGNORE));
+}
+
+Request isend(const void* buffer, std::size_t count, MPI_Datatype type, int dest, int tag, MPI_Comm comm)
+{
+    DerivedTypes derived_types;
+    auto [int_count, int_type] = derived_types.as_int_count(count, type);
+    MPI_Request request;
+    check_code(MPI_Isend(buffer, int_count, int_type, dest, tag, comm, &request));
+    return Request(request, false);
+}
+
+Request irecv(void* buffer, std::size_t count, MPI_Datatype type, int source, int tag, MPI_Comm comm)
+{
+    DerivedTypes derived_types;
+    auto [int_count, int_type] = derived_types.as_int_count(count, type);
+    MPI_Request request;
+    check_code(MPI_Irecv(buffer, int_count, int_type, source, tag, comm, &request));
+    return Request(request, false);
+}
+
+Request send_init(const void* buffer, std::size_t count, MPI_Datatype type, int dest, int tag, MPI_Comm comm)
+{
+    DerivedTypes derived_types;
+    auto [int_count, int_type] = derived_types.as_int_count(count, type);
+    MPI_Request request;
+    check_code(MPI_Send_init(buffer, int_count, int_type, dest, tag, comm, &request));
+    return Request(request, true);
+}
+
+Request recv_init(void* buffer, std::size_t count, MPI_Datatype type, int source, int tag, MPI_Comm comm)
+{
+    DerivedTypes derived_types;
+    auto [int_count, int_type] = derived_types.as_int_count(count, type);
+    MPI_Request request;
+    check_code(MPI_Recv_init(buffer, int_count, int_type, source, tag, comm, &request));
+    return Request(request, true);
+}
+
+void bcast(void* buffer, std::size_t count, MPI_Datatype type, int root, MPI_Comm comm)
+{
+    DerivedTypes derived_types;
+    auto [int_count, int_type] = derived_types.as_int_count(count, type);
+    check_code(MPI_Bcast(buffer, int_count, int_type, root, comm));
+}
+
+void scatterv(const void* send, std::size_t send_size, const Count* counts, const Displacement* displs,
+              void* recv, std::size_t recv_count, MPI_Datatype type, int root, MPI_Comm comm)
+{
+    DerivedTypes derived_types;
+    std::unique_ptr<Arguments> arguments = make_scatterv_arguments(send_size, counts, displs, recv_count, type, root, comm, derived_types);
+    if (fits_int(send_size))
+    {
+        check_code(MPI_Scatterv(send, arguments->send_counts.data(), arguments->send_displs.data(), type,
+                                recv, static_cast<int>(recv_count), type, root, comm));
+    }
+    else
+    {
+        check_code(MPI_Alltoallw(send, arguments->send_counts.data(), arguments->send_displs.data(), arguments->send_types.data(),
+                                 recv, arguments->recv_counts.data(), arguments->recv_displs.data(), arguments->recv_types.data(), comm));
+    }
+}
+
+Request iscatterv(const void* send, std::size_t send_size, const Count* counts, const Displacement* displs,
+                  void* recv, std::size_t recv_count, MPI_Datatype type, int root, MPI_Comm comm)
+{
+    DerivedTypes derived_types;
+    std::unique_ptr<Arguments> arguments = make_scatterv_arguments(send_size, counts, displs, recv_count, type, root, comm, derived_types);
+    MPI_Request request;
+    if (fits_int(send_size))
+    {
+        check_code(MPI_Iscatterv(send, arguments->send_counts.data(), arguments->send_displs.data(), type,
+                                 recv, static_cast<int>(recv_count), type, root, comm, &request));
+    }
+    else
+    {
+        check_code(MPI_Ialltoallw(send, arguments->send_counts.data(), arguments->send_displs.data(), arguments->send_types.data(),
+                                  recv, arguments->recv_counts.data(), arguments->recv_displs.data(), arguments->recv_types.data(),
+                                  comm, &request));
+    }
+    return Request(request, false, std::move(arguments));
+}
+
+void reduce(const void* send, void* recv, std::size_t count, MPI_Datatype type, MPI_Op op, int root, MPI_Comm comm)
+{
+    MPI_Aint extent = extent_of(type);
+    for (std::size_t first = 0; first < count; first += LARGE_BLOCK_SIZE)
+    {
+        MPI_Aint bytes = static_cast<MPI_Aint>(first) * extent;
+        int block_count = static_cast<int>(std::min(LARGE_BLOCK_SIZE, count - first));
+        check_code(MPI_Reduce(advance(send, bytes), advance(recv, bytes), block_count, type, op, root, comm));
+    }
+}
+
+Request ireduce(const void* send, void* recv, std::size_t count, MPI_Datatype type, MPI_Op op, int root, MPI_Comm comm)
+{
+    MPI_Request request;
+    check_code(MPI_Ireduce(send, recv, to_int(count), type, op, root, comm, &request));
+    return Request(request, false);
+}
+
+void allreduce(const void* send, void* recv, std::size_t count, MPI_Datatype type, MPI_Op op, MPI_Comm comm)
+{
+    MPI_Aint extent = extent_of(type);
+    for (std::size_t first = 0; first < count; first += LARGE_BLOCK_SIZE)
+    {
+        MPI_Aint bytes = static_cast<MPI_Aint>(first) * extent;
+        int block_count = static_cast<int>(std::min(LARGE_BLOCK_SIZE, count - first));
+        check_code(MPI_Allreduce(advance(send, bytes), advance(recv, bytes), block_count, type, op, comm));
+    }
+}
+
+// As in scatterv, the size of the receive buffer is known to all processes. Large blocks are
+// exchanged with MPI_Alltoallw: every process sends its block to everyone and receives the block
+// of every process at its displacement.
+void allgatherv(const void* send, std::size_t send_count, void* recv, std::size_t recv_size,
+                const Count* counts, const Displacement* displs, MPI_Datatype type, MPI_Comm comm)
+{
+    int size;
+    check_code(MPI_Comm_size(comm, &size));
+    if (fits_int(recv_size))
+    {
+        std::vector<int> int_counts(counts, counts + size);
+        std::vector<int> int_displs(displs, displs + size);
+        check_code(MPI_Allgatherv(send, static_cast<int>(send_count), type, recv, int_counts.data(), int_displs.data(), type, comm));
+        return;
+    }
+
+    DerivedTypes derived_types;
+    MPI_Aint extent = extent_of(type);
+    std::vector<int> send_counts(size, 0), recv_counts(size, 0);
+    std::vector<int> zero_displs(size, 0);
+    std::vector<MPI_Datatype> send_types(size, type), recv_types(size, type);
+    if (send_count > 0)
+    {
+        MPI_Datatype block = derived_types.make(send_count, type);
+        send_counts.assign(size, 1);
+        send_types.assign(size, block);
+    }
+    for (int i = 0; i < size; ++i)
+    {
+        if (counts[i] > 0)
+        {
+            recv_counts[i] = 1;
+            recv_types[i] = derived_types.make(static_cast<std::size_t>(counts[i]), type, displs[i] * extent);
+        }
+    }
+    check_code(MPI_Alltoallw(send, send_counts.data(), zero_displs.data(), send_types.data(),
+                             recv, recv_counts.data(), zero_displs.data(), recv_types.data(), comm));
+}
+
+#endif
+
+}  // namespace detail
+
+Communicator::~Communicator()
+{
+    if (m_owned && m_comm != MPI_COMM_NULL)
+    {
+        MPI_Comm_free(&m_comm);
+    }
+}
+
+Communicator Communicator::split(int color, int key) const
+{
+    MPI_Comm comm;
+    check_code(MPI_Comm_split(m_comm, color, key, &comm));
+    return Communicator(comm);
+}
+
+Communicator Communicator::duplicate() const
+{
+    MPI_Comm comm;
+    check_code(MPI_Comm_dup(m_comm, &comm));
+    return Communicator(comm);
+}
+
+int Communicator::rank() const
+{
+    int rank;
+    code_t code = MPI_Comm_rank(m_comm, &rank);
+    check_code(code);
+    return rank;
+}
+
+int Communicator::size() const
+{
+    int size;
+    code_t code = MPI_Comm_size(m_comm, &size);
+    check_code(code);
+    return size;
+}
+
+Communicator split_shared(MPI_Comm comm)
+{
+    int rank;
+    code_t code = MPI_Comm_rank(comm, &rank);
+    check_code(code);
+    MPI_Comm node;
+    code = MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, rank, MPI_INFO_NULL, &node);
+    check_code(code);
+    return Communicator(node);
+}
+
+Communicator split_node_leaders(const Communicator& node, MPI_Comm comm)
+{
+    int rank;
+    code_t code = MPI_Comm_rank(comm, &rank);
+    check_code(code);
+    MPI_Comm leaders;
+    code = MPI_Comm_split(comm, node.rank() == 0 ? 0 : MPI_UNDEFINED, rank, &leaders);
+    check_code(code);
+    return Communicator(leaders);
+}
+
+SharedWindow::SharedWindow(const Communicator& node, std::size_t size)
+    : m_node(node.get())
+{
+    void* base;
+    code_t code = MPI_Win_allocate_shared(static_cast<MPI_Aint>(size), 1, MPI_INFO_NULL, m_node, &base, &m_window);
+    check_code(code);
+    // Windows do not inherit the error handler of their communicator
+    code = MPI_Win_set_errhandler(m_window, MPI_ERRORS_RETURN);
+    if (code == MPI_SUCCESS)
+    {
+        code = MPI_Win_lock_all(MPI_MODE_NOCHECK, m_window);
+    }
+    if (code != MPI_SUCCESS)
+    {
+        MPI_Win_free(&m_window);
+        check_code(code);
+    }
+}
+
+SharedWindow::~SharedWindow()
+{
+    MPI_Win_unlock_all(m_window);
+    MPI_Win_free(&m_window);
+}
+
+void* SharedWindow::data(int rank) const
+{
+    MPI_Aint size;
+    int disp_unit;
+    void* base;
+    code_t code = MPI_Win_shared_query(m_window, rank, &size, &disp_unit, &base);
+    check_code(code);
+    return base;
+}
+
+std::size_t SharedWindow::size(int rank) const
+{
+    MPI_Aint size;
+    int disp_unit;
+    void* base;
+    code_t code = MPI_Win_shared_query(m_window, rank, &size, &disp_unit, &base);
+    check_code(code);
+    return static_cast<std::size_t>(size);
+}
+
+void SharedWindow::synchronize()
+{
+    code_t code = MPI_Win_sync(m_window);
+    check_code(code);
+    code = MPI_Barrier(m_node);
+    check_code(code);
+    code = MPI_Win_sync(m_window);
+    check_code(code);
+}
+
+void report_placement(std::ostream& out, int cpu)
+{
+    using host_t = std::array<char, MPI_MAX_PROCESSOR_NAME>;
+
+    host_t host{};
+    int host_length;
+    code_t code = MPI_Get_processor_name(host.data(), &host_length);
+    check_code(code);
+
+    const auto& params = Params::get_instance();
+    std::vector<host_t> hosts(is_current_process_root() ? params.process_count() : 0);
+    std::vector<int> cpus(is_current_process_root() ? params.process_count() : 0);
+
+    gather(host.data(), MPI_MAX_PROCESSOR_NAME, MPI_CHAR, hosts.data(), MPI_MAX_PROCESSOR_NAME, MPI_CHAR);
+    gather(&cpu, 1, MPI_INT, cpus.data(), 1, MPI_INT);
+
+    if (is_current_process_root())
+    {
+        out << "Placement:";
+        for (std::size_t i = 0; i < params.process_count(); ++i)
+        {
+            out << (i % 4 == 0 ? "\n   " : "") << " process " << i << " -> " << hosts[i].data() << ":" << cpus[i] << ";";
+        }
+        out << std::endl;
+    }
+}
+
 }  // namespace myLLmpi
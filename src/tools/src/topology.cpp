@@ -0,0 +1,314 @@
+#include <topology.hpp>
+
+#include <pthread.h>
+#include <sched.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <system_error>
+#include <tuple>
+
+namespace my::topology
+{
+
+namespace
+{
+
+// Parses Linux cpulist format, e.g. "0-3,8,10-11"
+std::vector<int> parse_cpu_list(std::string_view value)
+{
+    auto to_int = [value](std::string_view s) -> int
+    {
+        int n;
+        auto [ptr, ec] = std::from_chars(s.data(), s.data() + s.size(), n);
+        if (ec != std::errc() || ptr != s.data() + s.size() || n < 0)
+        {
+            throw std::invalid_argument("Error: invalid CPU list \"" + std::string(value) + "\"");
+        }
+        return n;
+    };
+
+    std::vector<int> cpus;
+    while (!value.empty() && value.back() == '\n')
+    {
+        value.remove_suffix(1);
+    }
+    std::size_t pos = 0;
+    while (pos < value.size())
+    {
+        std::size_t end = value.find(',', pos);
+        if (end == std::string_view::npos)
+        {
+            end = value.size();
+        }
+        std::string_view range = value.substr(pos, end - pos);
+        std::size_t dash = range.find('-');
+        if (dash == std::string_view::npos)
+        {
+            cpus.emplace_back(to_int(range));
+        }
+        else
+        {
+            int first = to_int(range.substr(0, dash));
+            int last = to_int(range.substr(dash + 1));
+            if (first > last)
+            {
+                throw std::invalid_argument("Error: invalid CPU list \"" + std::string(value) + "\"");
+            }
+            for (int cpu = first; cpu <= last; ++cpu)
+            {
+                cpus.emplace_back(cpu);
+            }
+        }
+        pos = end + 1;
+    }
+    return cpus;
+}
+
+std::string read_file(const std::filesystem::path& path)
+{
+    std::ifstream file(path);
+    std::stringstream content;
+    content << file.rdbuf();
+    return content.str();
+}
+
+int read_int(const std::filesystem::path& path, int default_value)
+{
+    std::ifstream file(path);
+    int value;
+    return (file >> value) ? value : default_value;
+}
+
+}  // namespace
+
+Topology Topology::detect()
+{
+    cpu_set_t affinity;
+    CPU_ZERO(&affinity);
+    if (sched_getaffinity(0, sizeof(affinity), &affinity) != 0)
+    {
+        throw std::system_error(errno, std::generic_category(), "sched_getaffinity");
+    }
+
+    const std::filesystem::path cpu_root = "/sys/devices/system/cpu";
+    const std::filesystem::path node_root = "/sys/devices/system/node";
+
+    std::map<int, int> numa_node_of_cpu;
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(node_root, ec))
+    {
+        std::string name = entry.path().filename().string();
+        if (name.rfind("node", 0) != 0 || name.size() == 4 || name.find_first_not_of("0123456789", 4) != std::string::npos)
+        {
+            continue;
+        }
+        int node = std::stoi(name.substr(4));
+        for (int cpu : parse_cpu_list(read_file(entry.path() / "cpulist")))
+        {
+            numa_node_of_cpu[cpu] = node;
+        }
+    }
+
+    std::vector<Cpu> cpus;
+    for (int id = 0; id < CPU_SETSIZE; ++id)
+    {
+        if (!CPU_ISSET(id, &affinity))
+        {
+            continue;
+        }
+
+        std::filesystem::path topology_dir = cpu_root / ("cpu" + std::to_string(id)) / "topology";
+        Cpu cpu{ .id = id,
+                 .package_id = read_int(topology_dir / "physical_package_id", 0),
+                 .core_id = read_int(topology_dir / "core_id", id),
+                 .numa_node = numa_node_of_cpu.count(id) != 0 ? numa_node_of_cpu[id] : 0,
+                 .smt_index = 0 };
+
+        std::string siblings = read_file(topology_dir / "thread_siblings_list");
+        if (!siblings.empty())
+        {
+            std::vector<int> sibling_ids = parse_cpu_list(siblings);
+            std::sort(sibling_ids.begin(), sibling_ids.end());
+            cpu.smt_index = static_cast<int>(std::lower_bound(sibling_ids.begin(), sibling_ids.end(), id) - sibling_ids.begin());
+        }
+
+        cpus.emplace_back(cpu);
+    }
+
+    if (cpus.empty())
+    {
+        throw std::runtime_error("No CPUs detected");
+    }
+
+    return Topology(std::move(cpus));
+}
+
+std::size_t Topology::packages_count() const
+{
+    std::set<int> packages;
+    for (const Cpu& cpu : m_cpus)
+    {
+        packages.emplace(cpu.package_id);
+    }
+    return packages.size();
+}
+
+std::size_t Topology::cores_count() const
+{
+    std::set<std::pair<int, int>> cores;
+    for (const Cpu& cpu : m_cpus)
+    {
+        cores.emplace(cpu.package_id, cpu.core_id);
+    }
+    return cores.size();
+}
+
+std::size_t Topology::numa_nodes_count() const
+{
+    std::set<int> nodes;
+    for (const Cpu& cpu : m_cpus)
+    {
+        nodes.emplace(cpu.numa_node);
+    }
+    return nodes.size();
+}
+
+std::string Topology::describe() const
+{
+    std::ostringstream out;
+    out << packages_count() << " socket(s), "
+        << cores_count() << " core(s), "
+        << m_cpus.size() << " hardware thread(s), "
+        << numa_nodes_count() << " NUMA node(s)";
+    return out.str();
+}
+
+Pinning pinning_from_string(std::string_view value)
+{
+    if (value == "none")
+        return { .policy = PinningPolicy::NONE };
+    if (value == "compact")
+        return { .policy = PinningPolicy::COMPACT };
+    if (value == "scatter")
+        return { .policy = PinningPolicy::SCATTER };
+
+    Pinning pinning{ .policy = PinningPolicy::EXPLICIT, .cpu_list = parse_cpu_list(value) };
+    if (pinning.cpu_list.empty())
+    {
+        throw std::invalid_argument("Error: empty CPU list");
+    }
+    return pinning;
+}
+
+std::string_view to_string(PinningPolicy policy)
+{
+    switch (policy)
+    {
+    case PinningPolicy::NONE:     return "none";
+    case PinningPolicy::COMPACT:  return "compact";
+    case PinningPolicy::SCATTER:  return "scatter";
+    case PinningPolicy::EXPLICIT: return "explicit";
+    }
+    return "unknown";
+}
+
+std::vector<int> make_placement(const Topology& topology, const Pinning& pinning, std::size_t slots_count)
+{
+    std::vector<int> order;
+    switch (pinning.policy)
+    {
+    case PinningPolicy::NONE:
+        return {};
+
+    case PinningPolicy::EXPLICIT:
+        order = pinning.cpu_list;
+        break;
+
+    case PinningPolicy::COMPACT:
+    {
+        std::vector<Cpu> cpus = topology.cpus();
+        std::sort(cpus.begin(), cpus.end(), [](const Cpu& a, const Cpu& b)
+        {
+            return std::tie(a.package_id, a.core_id, a.smt_index) < std::tie(b.package_id, b.core_id, b.smt_index);
+        });
+        for (const Cpu& cpu : cpus)
+        {
+            order.emplace_back(cpu.id);
+        }
+        break;
+    }
+
+    case PinningPolicy::SCATTER:
+    {
+        // Rank cores within their package, then interleave packages
+        std::map<std::pair<int, int>, int> core_index;
+        std::map<int, int> cores_in_package;
+        std::vector<Cpu> cpus = topology.cpus();
+        std::sort(cpus.begin(), cpus.end(), [](const Cpu& a, const Cpu& b)
+        {
+            return std::tie(a.package_id, a.core_id) < std::tie(b.package_id, b.core_id);
+        });
+        for (const Cpu& cpu : cpus)
+        {
+            auto key = std::make_pair(cpu.package_id, cpu.core_id);
+            if (core_index.count(key) == 0)
+            {
+                core_index[key] = cores_in_package[cpu.package_id]++;
+            }
+        }
+        std::sort(cpus.begin(), cpus.end(), [&core_index](const Cpu& a, const Cpu& b)
+        {
+            int a_core = core_index.at({ a.package_id, a.core_id });
+            int b_core = core_index.at({ b.package_id, b.core_id });
+            return std::tie(a.smt_index, a_core, a.package_id) < std::tie(b.smt_index, b_core, b.package_id);
+        });
+        for (const Cpu& cpu : cpus)
+        {
+            order.emplace_back(cpu.id);
+        }
+        break;
+    }
+    }
+
+    if (order.empty())
+    {
+        throw std::invalid_argument("Error: no CPUs to pin to");
+    }
+    if (slots_count > order.size())
+    {
+        throw std::invalid_argument("Error: cannot pin " + std::to_string(slots_count) + " threads or processes to " +
+                                    std::to_string(order.size()) + " CPUs without oversubscribing them");
+    }
+    return std::vector<int>(order.begin(), order.begin() + static_cast<std::ptrdiff_t>(slots_count));
+}
+
+void pin_current_thread(int cpu)
+{
+    if (cpu < 0 || cpu >= CPU_SETSIZE)
+    {
+        throw std::invalid_argument("Error: CPU " + std::to_string(cpu) + " is out of range");
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    int code = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    if (code != 0)
+    {
+        throw std::system_error(code, std::generic_category(), "Cannot pin thread to CPU " + std::to_string(cpu));
+    }
+}
+
+int current_cpu()
+{
+    return sched_getcpu();
+}
+
+}  // namespace my::topology